@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <cmath>
+#include "Autopilot.hpp"
+#include "Replay.hpp"
+#include "entities/EntityManager.hpp"
+#include "entities/Player.hpp"
+
+// Player's trajectory is checked every STEP seconds, during HORIZON seconds
+#define HORIZON 0.6f
+#define STEP    0.1f
+// Safety distance around the player, in pixels
+#define MARGIN  6.f
+// Minimum delay between two missiles, in seconds
+#define MISSILE_DELAY 2.f
+// Enemies larger than this area are worth a missile (bosses and decors)
+#define BIG_TARGET_AREA 10000.f
+// Vertical offset of the laser, from player's position
+#define LASER_Y 24.f
+
+static const sf::Vector2f DIRECTIONS[] = {
+    sf::Vector2f(0, 0),
+    sf::Vector2f(0, -1), sf::Vector2f(0, 1), sf::Vector2f(-1, 0), sf::Vector2f(1, 0),
+    sf::Vector2f(-1, -1), sf::Vector2f(1, -1), sf::Vector2f(-1, 1), sf::Vector2f(1, 1)
+};
+static const int DIRECTION_COUNT = sizeof (DIRECTIONS) / sizeof (DIRECTIONS[0]);
+
+// Actions hold down by the pilot
+static const Action::ID CONTROLS[] = {
+    Action::UP, Action::DOWN, Action::LEFT, Action::RIGHT, Action::USE_LASER
+};
+static const int CONTROL_COUNT = sizeof (CONTROLS) / sizeof (CONTROLS[0]);
+
+bool                 Autopilot::s_enabled = false;
+Autopilot::TargetMap Autopilot::s_targets;
+std::vector<Autopilot::Target> Autopilot::s_lasers;
+float                Autopilot::s_missile_timer = 0.f;
+int                  Autopilot::s_direction = 0;
+
+
+void Autopilot::setEnabled(bool enabled)
+{
+    s_enabled = enabled;
+}
+
+
+bool Autopilot::isEnabled()
+{
+    return s_enabled;
+}
+
+
+void Autopilot::reset()
+{
+    s_targets.clear();
+    s_lasers.clear();
+    s_missile_timer = 0.f;
+    s_direction = 0;
+}
+
+
+void Autopilot::update(Player& player, float frametime)
+{
+    const sf::FloatRect player_box = player.getBoundingBox();
+    const float laser_y = player.getY() + LASER_Y;
+
+    // Track other entities, and look for enemies in front of the player
+    TargetMap targets;
+    float aim_y = player_box.top + player_box.height / 2;
+    float closest = -1.f;
+    int enemies_ahead = 0;
+    bool big_target_ahead = false;
+    bool aligned = false;
+    for (const Entity* entity: EntityManager::getInstance().getEntities())
+    {
+        if (entity == &player || entity->isDead() || entity->getTeam() == Entity::GOOD)
+            continue;
+
+        // Entities are tracked by serial, a new entity may reuse the address of a dead one
+        Target& target = targets[entity->getSerial()];
+        target.box = entity->getBoundingBox();
+        target.bonus = entity->getTypeID() == Entity::POWERUP;
+        TargetMap::const_iterator previous = s_targets.find(entity->getSerial());
+        if (previous != s_targets.end() && frametime > 0)
+        {
+            target.speed.x = (target.box.left - previous->second.box.left) / frametime;
+            target.speed.y = (target.box.top - previous->second.box.top) / frametime;
+        }
+
+        if (target.bonus || target.box.left < player_box.left + player_box.width)
+            continue;
+
+        // Projectiles are too small to be worth chasing
+        float area = target.box.width * target.box.height;
+        if (area > 24 * 24)
+        {
+            ++enemies_ahead;
+            big_target_ahead |= area > BIG_TARGET_AREA;
+            float distance = target.box.left - player_box.left;
+            if (closest < 0 || distance < closest)
+            {
+                closest = distance;
+                aim_y = target.box.top + target.box.height / 2 - LASER_Y + player_box.height / 2;
+            }
+        }
+        if (laser_y > target.box.top && laser_y < target.box.top + target.box.height)
+            aligned = true;
+    }
+    s_targets.swap(targets);
+
+    // Lasers aren't entities, but their speed is known
+    const ProjectileSystem& projectiles = EntityManager::getInstance().getProjectiles();
+    s_lasers.clear();
+    for (size_t i = 0; i < projectiles.getCount(); ++i)
+    {
+        if (projectiles.getTeam(i) != player.getTeam())
+        {
+            Target laser;
+            laser.box = projectiles.getBoundingBox(i);
+            laser.speed = projectiles.getSpeed(i);
+            laser.bonus = false;
+            s_lasers.push_back(laser);
+        }
+    }
+
+    // Pick the safest direction, keep the current one unless another is clearly better
+    int best = s_direction;
+    float best_cost = evaluate(player, DIRECTIONS[s_direction], aim_y) - 0.05f;
+    for (int i = 0; i < DIRECTION_COUNT; ++i)
+    {
+        float cost = evaluate(player, DIRECTIONS[i], aim_y);
+        if (cost < best_cost)
+        {
+            best = i;
+            best_cost = cost;
+        }
+    }
+    s_direction = best;
+
+    const sf::Vector2f& direction = DIRECTIONS[best];
+    bool pressed[CONTROL_COUNT] = {
+        direction.y < 0, direction.y > 0, direction.x < 0, direction.x > 0, aligned && !player.isOverheated()
+    };
+
+    // Release actions before pressing new ones, so player's animation matches the pressed actions
+    uint32_t state = Input::getPressedState();
+    for (int i = 0; i < CONTROL_COUNT; ++i)
+        if (!pressed[i])
+            setPressed(player, state, CONTROLS[i], false);
+
+    for (int i = 0; i < CONTROL_COUNT; ++i)
+        if (pressed[i])
+            setPressed(player, state, CONTROLS[i], true);
+
+    Input::setPressedState(state);
+
+    // Special weapons
+    if (player.isOverheated() && player.getIcecubeCount() > 0)
+        trigger(player, Action::USE_COOLER);
+
+    s_missile_timer += frametime;
+    if (player.getMissileCount() > 0 && s_missile_timer > MISSILE_DELAY && (big_target_ahead || enemies_ahead >= 5))
+    {
+        trigger(player, Action::USE_MISSILE);
+        s_missile_timer = 0.f;
+    }
+}
+
+
+float Autopilot::evaluate(const Player& player, const sf::Vector2f& direction, float aim_y)
+{
+    const EntityManager& entities = EntityManager::getInstance();
+    const sf::FloatRect box = player.getBoundingBox();
+    const float max_x = entities.getWidth() - box.width;
+    const float max_y = entities.getHeight() - box.height;
+    const float speed = player.getSpeed() * (direction.x != 0 && direction.y != 0 ? std::sqrt(0.5f) : 1.f);
+
+    float cost = 0.f;
+    sf::FloatRect predicted = box;
+    for (float t = STEP; t <= HORIZON + STEP / 2; t += STEP)
+    {
+        // Player stops on screen borders
+        predicted.left = std::min(std::max(box.left + direction.x * speed * t, 0.f), max_x);
+        predicted.top = std::min(std::max(box.top + direction.y * speed * t, 0.f), max_y);
+        sf::FloatRect area(predicted.left - MARGIN, predicted.top - MARGIN, box.width + MARGIN * 2, box.height + MARGIN * 2);
+
+        for (TargetMap::const_iterator it = s_targets.begin(); it != s_targets.end(); ++it)
+            cost += getCollisionCost(area, it->second, t);
+
+        for (const Target& laser: s_lasers)
+            cost += getCollisionCost(area, laser, t);
+    }
+
+    // Stay on the left side of the screen, in front of the closest enemy
+    cost += std::abs(predicted.left - entities.getWidth() * 0.2f) / entities.getWidth();
+    cost += std::abs(predicted.top + box.height / 2 - aim_y) / entities.getHeight();
+    return cost;
+}
+
+
+float Autopilot::getCollisionCost(const sf::FloatRect& area, const Target& target, float t)
+{
+    sf::FloatRect future = target.box;
+    future.left += target.speed.x * t;
+    future.top += target.speed.y * t;
+    if (!area.intersects(future))
+        return 0.f;
+
+    // Nearest collisions are the most dangerous
+    return target.bonus ? -1.f : 10.f * (HORIZON + STEP - t);
+}
+
+
+void Autopilot::setPressed(Player& player, uint32_t& state, Action::ID action, bool pressed)
+{
+    const uint32_t bit = 1u << action;
+    if (((state & bit) != 0) == pressed)
+        return;
+
+    Replay::recordAction(action, pressed);
+    if (pressed)
+    {
+        state |= bit;
+        player.onActionDown(action);
+    }
+    else
+    {
+        state &= ~bit;
+        player.onActionUp(action);
+    }
+}
+
+
+void Autopilot::trigger(Player& player, Action::ID action)
+{
+    Replay::recordAction(action, true);
+    player.onActionDown(action);
+    Replay::recordAction(action, false);
+    player.onActionUp(action);
+}
@@ -0,0 +1,73 @@
+#ifndef AUTOPILOT_HPP
+#define AUTOPILOT_HPP
+
+#include <cstdint>
+#include <map>
+#include <vector>
+#include <SFML/Graphics/Rect.hpp>
+#include "Input.hpp"
+
+class Player;
+
+/**
+ * Static class for a scripted pilot playing instead of the user
+ * The pilot drives the player through the actions state and Player::onActionDown /
+ * Player::onActionUp, as the user would: it dodges entities and projectiles, shoots
+ * enemies in front of the player, and uses coolers and missiles.
+ */
+class Autopilot
+{
+public:
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    /**
+     * Forget tracked entities, must be called when a level starts
+     */
+    static void reset();
+
+    /**
+     * Decide the actions of the current frame, must be called once per frame
+     * before entities are updated
+     * Actions sent to the player are recorded if a replay is being recorded.
+     */
+    static void update(Player& player, float frametime);
+
+private:
+    struct Target
+    {
+        sf::FloatRect box;
+        sf::Vector2f  speed; // Estimated from the position in the previous frame
+        bool          bonus; // Power-up, collected instead of avoided
+    };
+
+    /**
+     * Cost of moving the player in a given direction (lower is better)
+     * @param aim_y: vertical position where the player can shoot the closest enemy
+     */
+    static float evaluate(const Player& player, const sf::Vector2f& direction, float aim_y);
+
+    /**
+     * Cost of the player area colliding with a target, t seconds from now
+     */
+    static float getCollisionCost(const sf::FloatRect& area, const Target& target, float t);
+
+    /**
+     * Press or release an action, and notify the player
+     */
+    static void setPressed(Player& player, uint32_t& state, Action::ID action, bool pressed);
+
+    /**
+     * Press and release an action immediately
+     */
+    static void trigger(Player& player, Action::ID action);
+
+    typedef std::map<uint32_t, Target> TargetMap; // Indexed by entity serial
+    static bool                s_enabled;
+    static TargetMap           s_targets;
+    static std::vector<Target> s_lasers;  // Lasers of the other team
+    static float     s_missile_timer; // Time since the last missile was launched
+    static int       s_direction;     // Index of the current direction
+};
+
+#endif // AUTOPILOT_HPP
@@ -0,0 +1,290 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <vector>
+#include <SFML/System/Clock.hpp>
+#include "Autopilot.hpp"
+#include "Benchmark.hpp"
+#include "LevelManager.hpp"
+#include "ParticleSystem.hpp"
+#include "Replay.hpp"
+#include "SoundSystem.hpp"
+#include "UserSettings.hpp"
+#include "entities/EntityManager.hpp"
+#include "entities/Player.hpp"
+#include "items/ItemManager.hpp"
+#include "utils/FileSystem.hpp"
+#include "utils/Math.hpp"
+#include "utils/StringUtils.hpp"
+
+// Levels without replay file are played by the autopilot, with a fixed frame time and seed
+#define BENCH_FRAMETIME  (1.f / 60)
+#define BENCH_SEED       1
+// Stop levels which last longer than 10 minutes
+#define BENCH_MAX_FRAMES (60 * 60 * 10)
+
+#ifdef COUNT_ALLOCATIONS
+static std::atomic<size_t> s_allocations(0);
+
+// Global allocation functions, counting allocations ---------------------------
+// Only compiled in the benchmark build ('make bench'), other builds keep the default ones
+
+void* operator new(size_t size)
+{
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == NULL)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+#endif
+
+
+namespace {
+
+struct Frame
+{
+    float  sim_ms;      // Time spent in EntityManager::spawnBadGuys and EntityManager::update
+    size_t entities;
+    size_t culled;      // Sleeping entities, not updated yet
+    size_t particles;
+    size_t allocations;
+};
+
+
+struct LevelReport
+{
+    size_t             level;
+    bool               replay;    // Played from a replay file
+    bool               completed; // Player is alive at the end of the level
+    float              game_time;
+    std::vector<Frame> frames;
+};
+
+
+template <class T>
+float percentile(std::vector<T> values, float p)
+{
+    if (values.empty())
+        return 0.f;
+    std::sort(values.begin(), values.end());
+    size_t index = static_cast<size_t>(p * (values.size() - 1) + 0.5f);
+    return values[index];
+}
+
+
+template <class T>
+float mean(const std::vector<T>& values)
+{
+    if (values.empty())
+        return 0.f;
+    double total = 0;
+    for (const T& value: values)
+        total += value;
+    return total / values.size();
+}
+
+
+template <class T>
+void write_array(std::ostream& out, const char* name, const std::vector<T>& values)
+{
+    out << "        \"" << name << "\": [";
+    for (size_t i = 0; i < values.size(); ++i)
+        out << (i ? ", " : "") << values[i];
+    out << "]";
+}
+
+
+template <class T>
+void write_stats(std::ostream& out, const char* name, const std::vector<T>& values)
+{
+    out << "        \"" << name << "\": {\"mean\": " << mean(values)
+        << ", \"p50\": " << percentile(values, 0.50f)
+        << ", \"p95\": " << percentile(values, 0.95f)
+        << ", \"p99\": " << percentile(values, 0.99f)
+        << ", \"max\": " << percentile(values, 1.f) << "},\n";
+}
+
+
+void write_level(std::ostream& out, const LevelReport& report)
+{
+    std::vector<float> sim_ms;
+    std::vector<size_t> entities, culled, particles, allocations;
+    size_t total_allocations = 0;
+    for (const Frame& frame: report.frames)
+    {
+        sim_ms.push_back(frame.sim_ms);
+        entities.push_back(frame.entities);
+        culled.push_back(frame.culled);
+        particles.push_back(frame.particles);
+        allocations.push_back(frame.allocations);
+        total_allocations += frame.allocations;
+    }
+
+    out << "    {\n"
+        << "        \"level\": " << report.level << ",\n"
+        << "        \"trace\": \"" << (report.replay ? "replay" : "autopilot") << "\",\n"
+        << "        \"frames\": " << report.frames.size() << ",\n"
+        << "        \"game_time\": " << report.game_time << ",\n"
+        << "        \"completed\": " << (report.completed ? "true" : "false") << ",\n";
+    write_stats(out, "sim_ms", sim_ms);
+    write_stats(out, "entities", entities);
+    write_stats(out, "culled", culled);
+    write_stats(out, "particles", particles);
+    write_stats(out, "allocations", allocations);
+    out << "        \"total_allocations\": " << total_allocations << ",\n";
+    write_array(out, "sim_ms_samples", sim_ms);
+    out << ",\n";
+    write_array(out, "entities_samples", entities);
+    out << ",\n";
+    write_array(out, "particles_samples", particles);
+    out << ",\n";
+    write_array(out, "allocations_samples", allocations);
+    out << "\n    }";
+}
+
+}
+
+
+int Benchmark::run(const std::string& report_file, size_t only_level, float start_time)
+{
+    SoundSystem::enableMusic(false);
+    SoundSystem::enableSound(false);
+
+    LevelManager& levels = LevelManager::getInstance();
+    EntityManager& entities = EntityManager::getInstance();
+    const ParticleSystem& particles = ParticleSystem::getInstance();
+    levels.setLastUnlocked(levels.getLevelCount());
+
+    std::vector<LevelReport> reports;
+    const std::string trace_dir = utils::dirname(report_file);
+    for (size_t level = 1; level <= levels.getLevelCount(); ++level)
+    {
+        if (only_level > 0 && level != only_level)
+            continue;
+
+        LevelReport report;
+        report.level = level;
+        report.game_time = 0.f;
+
+        // Use the recorded trace of this level if any, or let the autopilot play
+        std::string trace = trace_dir + "level-" + std::to_string(level) + ".replay";
+        report.replay = start_time <= 0 && filesystem::is_file(trace) && Replay::loadFromFile(trace);
+        if (report.replay && Replay::getLevel() != level)
+        {
+            std::cerr << "[Benchmark] " << trace << " is a replay of level " << Replay::getLevel() << ", ignored" << std::endl;
+            report.replay = false;
+        }
+        if (!report.replay)
+        {
+            Replay::reset();
+            math::set_seed(BENCH_SEED);
+
+            // Give the autopilot the best items, so it goes as far as possible in the level
+            const ItemManager& items = ItemManager::getInstance();
+            for (int i = 0; i < Item::_COUNT; ++i)
+            {
+                Item::Type type = static_cast<Item::Type>(i);
+                int item_level = 1;
+                while (items.hasItem(type, item_level + 1))
+                    ++item_level;
+                UserSettings::setItemLevel(type, item_level);
+            }
+        }
+
+        Replay::beginLevel(level);
+        levels.setCurrent(level);
+        levels.initCurrentLevel();
+        entities.initialize(true);
+        if (start_time > 0)
+            entities.seek(start_time);
+        report.game_time = entities.getTimer();
+        Autopilot::reset();
+
+        std::cout << "* benchmarking level " << level << "..." << std::endl;
+        sf::Clock clock;
+        while (report.frames.size() < BENCH_MAX_FRAMES)
+        {
+            float frametime = BENCH_FRAMETIME;
+            if (report.replay)
+            {
+                if (!Replay::playFrame(frametime, *entities.getPlayer()))
+                    break;
+            }
+            else
+            {
+                Autopilot::update(*entities.getPlayer(), frametime);
+            }
+
+            Frame frame;
+            size_t allocations = getAllocationCount();
+            clock.restart();
+            bool game_over = entities.spawnBadGuys();
+            if (!game_over)
+                entities.update(frametime);
+
+            frame.sim_ms = clock.getElapsedTime().asMicroseconds() / 1000.f;
+            frame.allocations = getAllocationCount() - allocations;
+            frame.entities = entities.getEntityCount();
+            frame.culled = entities.getCulledCount();
+            frame.particles = particles.getParticleCount();
+            report.frames.push_back(frame);
+            if (game_over)
+                break;
+
+            report.game_time += frametime;
+        }
+        report.completed = !entities.getPlayer()->isDead();
+        reports.push_back(report);
+        Replay::reset();
+    }
+
+    std::ofstream out(report_file.c_str());
+    out << "{\n"
+        << "\"seed\": " << BENCH_SEED << ",\n"
+        << "\"levels\": [\n";
+    for (size_t i = 0; i < reports.size(); ++i)
+    {
+        write_level(out, reports[i]);
+        out << (i + 1 < reports.size() ? ",\n" : "\n");
+    }
+    out << "]\n}\n";
+    if (!out)
+    {
+        std::cerr << "[Benchmark] cannot write " << report_file << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "* benchmark report written to " << report_file << std::endl;
+    return EXIT_SUCCESS;
+}
+
+
+size_t Benchmark::getAllocationCount()
+{
+#ifdef COUNT_ALLOCATIONS
+    return s_allocations.load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,32 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <string>
+
+/**
+ * Performance harness: play every level without rendering, and write per-frame
+ * simulation time, entity count, particle count and memory allocations to a JSON
+ * report (compare reports with tools/compare_bench.py)
+ */
+class Benchmark
+{
+public:
+    /**
+     * Run the benchmark on all levels
+     * Level N is played with the replay file "level-N.replay" from the report directory
+     * if it exists, or by the autopilot otherwise.
+     * @param report_file: path to the JSON report
+     * @param level: if not 0, only this level is played
+     * @param start_time: time in seconds where levels start (replays are ignored)
+     * @return process exit code
+     */
+    static int run(const std::string& report_file, size_t level = 0, float start_time = 0.f);
+
+    /**
+     * Number of memory allocations since program start
+     * Allocations are only counted when built with COUNT_ALLOCATIONS ('make bench'), 0 otherwise
+     */
+    static size_t getAllocationCount();
+};
+
+#endif // BENCHMARK_HPP
@@ -1,7 +1,37 @@
+#include <algorithm>
+#include <cmath>
 #include "Collisions.hpp"
+#include "Resources.hpp"
+
+// Maximum number of pixel-perfect tests along a trajectory
+#define SWEPT_MAX_STEPS 32
 
 Collisions::ImageMap Collisions::images_;
 
+namespace {
+
+/**
+ * Clip the time interval [entry, exit] to the times where the segment [pos, pos + size],
+ * moving by motion during the frame, overlaps the segment [target, target + target_size]
+ * @return false if segments don't overlap during the interval
+ */
+bool clip_axis(float pos, float size, float target, float target_size, float motion, float& entry, float& exit)
+{
+    if (motion == 0)
+        return pos < target + target_size && pos + size > target;
+
+    float t0 = (target - (pos + size)) / motion;
+    float t1 = (target + target_size - pos) / motion;
+    if (t0 > t1)
+        std::swap(t0, t1);
+
+    entry = std::max(entry, t0);
+    exit = std::min(exit, t1);
+    return entry <= exit;
+}
+
+}
+
 
 // Gets to the alpha component of pixelsPtr[x,y] (Picture width being provided)
 #define ALPHACOMP(buf, width, x, y) (buf[((x) + (y) * (width)) * 4 + 3])
@@ -57,8 +87,48 @@ bool Collisions::pixelPerfectTest(const sf::Sprite& a, const sf::Sprite& b)
 }
 
 
+bool Collisions::sweptTest(const sf::Sprite& a, const sf::Vector2f& motion_a,
+                           const sf::Sprite& b, const sf::Vector2f& motion_b)
+{
+    // Motion of a, relative to b
+    const sf::Vector2f motion = motion_a - motion_b;
+    const sf::IntRect& rect_a = a.getTextureRect();
+    const sf::IntRect& rect_b = b.getTextureRect();
+
+    // Sprites cannot pass through each other if they move less than half their size
+    const float step = std::max(std::min(std::min(rect_a.width, rect_a.height), std::min(rect_b.width, rect_b.height)) / 2.f, 1.f);
+    const float distance = std::max(std::abs(motion.x), std::abs(motion.y));
+    if (distance <= step)
+        return pixelPerfectTest(a, b);
+
+    // Swept bounding boxes, from the beginning of the frame
+    const sf::Vector2f start_a = a.getPosition() - a.getOrigin() - motion_a;
+    const sf::Vector2f start_b = b.getPosition() - b.getOrigin() - motion_b;
+    float entry = 0.f, exit = 1.f;
+    if (!clip_axis(start_a.x, rect_a.width, start_b.x, rect_b.width, motion.x, entry, exit)
+        || !clip_axis(start_a.y, rect_a.height, start_b.y, rect_b.height, motion.y, entry, exit))
+        return false;
+
+    // Pixel-perfect tests where bounding boxes overlap
+    int steps = std::min(static_cast<int>((exit - entry) * distance / step) + 1, SWEPT_MAX_STEPS);
+    sf::Sprite probe_a(a);
+    sf::Sprite probe_b(b);
+    for (int i = 0; i <= steps; ++i)
+    {
+        float remaining = 1.f - (entry + (exit - entry) * i / steps);
+        probe_a.setPosition(a.getPosition() - motion_a * remaining);
+        probe_b.setPosition(b.getPosition() - motion_b * remaining);
+        if (pixelPerfectTest(probe_a, probe_b))
+            return true;
+    }
+    return false;
+}
+
+
 void Collisions::registerTexture(const sf::Texture* texture)
 {
+    // Reading the texture back uses OpenGL, textures may be registered while loading resources
+    Resources::ContextLock lock;
     ImageMap::const_iterator it = images_.find(texture);
     if (it == images_.end())
         images_[texture] = texture->copyToImage();
@@ -22,6 +22,17 @@ public:
      */
     static bool pixelPerfectTest(const sf::Sprite& a, const sf::Sprite& b);
 
+    /**
+     * Continuous collision: pixel-perfect test along the sprites trajectories, so
+     * fast sprites cannot pass through thin ones on long frames
+     * Falls back to pixelPerfectTest when sprites move less than their size.
+     * @param motion_a: displacement of a since the previous frame (a is at its final position)
+     * @param motion_b: displacement of b since the previous frame
+     * @return a colliding with b at some point of the frame
+     */
+    static bool sweptTest(const sf::Sprite& a, const sf::Vector2f& motion_a,
+                          const sf::Sprite& b, const sf::Vector2f& motion_b);
+
 private:
     typedef std::map<const sf::Texture*, sf::Image> ImageMap;
 
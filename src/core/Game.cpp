@@ -1,4 +1,6 @@
+#include <cstdio>
 #include <iostream>
+#include <mutex>
 
 #include "Game.hpp"
 #include "Constants.hpp"
@@ -7,11 +9,16 @@
 #include "Resources.hpp"
 #include "SoundSystem.hpp"
 #include "MessageSystem.hpp"
+#include "ControlPanel.hpp"
+#include "Replay.hpp"
+#include "Autopilot.hpp"
+#include "StartupReport.hpp"
 #include "entities/EntityManager.hpp"
 #include "items/ItemManager.hpp"
 #include "utils/I18n.hpp"
 #include "utils/IniParser.hpp"
 #include "utils/FileSystem.hpp"
+#include "utils/TaskGraph.hpp"
 #include "scenes/scenes.hpp"
 
 // config and data files
@@ -22,6 +29,43 @@
 #define XML_WEAPONS     "/xml/weapons.xml"
 #define XML_ANIMATIONS  "/xml/animations.xml"
 #define XML_SPACESHIPS  "/xml/spaceships.xml"
+#define XML_SOUNDS      "/xml/sounds.xml"
+#define RESOURCE_PACK   "/resources.pack"
+
+
+/**
+ * Print a line of the loading log, tasks may be running in several threads
+ */
+static void log_loading(std::ostream& out, const std::string& line)
+{
+    static std::mutex mutex;
+    std::lock_guard<std::mutex> lock(mutex);
+    out << line << std::endl;
+}
+
+/**
+ * Task loading a data file, loading time is added to the startup report
+ * @param filename: path relative to the resources directory
+ */
+static TaskGraph::Task load_file(const std::string& directory, const char* filename, const std::function<void(const std::string&)>& loader)
+{
+    return [directory, filename, loader]() {
+        log_loading(std::cout, std::string("* loading ") + filename + "...");
+        const std::string path = directory + filename;
+        const float start = StartupReport::getTime();
+        try
+        {
+            loader(path);
+        }
+        catch (...)
+        {
+            log_loading(std::cerr, std::string("* cannot load ") + filename);
+            throw;
+        }
+        if (StartupReport::isEnabled())
+            StartupReport::add(StartupReport::DATA_FILE, path, filesystem::file_size(path), start, StartupReport::getTime());
+    };
+}
 
 
 Game& Game::getInstance()
@@ -34,6 +78,11 @@ Game& Game::getInstance()
 Game::Game():
     m_vsync(false),
     m_running(true),
+    m_headless(false),
+    m_debug_level(0),
+    m_debug_start_time(0.f),
+    m_hot_reload(false),
+    m_reload_time(-1.f),
     m_current_screen(NULL)
 {
     // Screens will be allocated on the fly
@@ -73,36 +122,49 @@ void Game::loadResources(const std::string& data_path)
     // Init resources directory
     std::string resources_dir = m_app_dir + data_path;
     Resources::setSearchPath(resources_dir);
+    if (Resources::openPack(resources_dir + RESOURCE_PACK))
+        std::cout << "* using " << RESOURCE_PACK << std::endl;
 
     // Splash screen
-    setResolution(sf::Vector2u(APP_WIDTH, APP_HEIGHT));
-    sf::Sprite s(Resources::getTexture("gui/cosmoscroll-logo.png"));
-    s.setPosition(
-        (APP_WIDTH - s.getTextureRect().width) / 2.f,
-        (APP_HEIGHT - s.getTextureRect().height) / 2.f
-    );
-    m_window.draw(s);
-    m_window.display();
+    if (!m_headless)
+    {
+        setResolution(sf::Vector2u(APP_WIDTH, APP_HEIGHT));
+        sf::Sprite s(Resources::getTexture("gui/cosmoscroll-logo.png"));
+        s.setPosition(
+            (APP_WIDTH - s.getTextureRect().width) / 2.f,
+            (APP_HEIGHT - s.getTextureRect().height) / 2.f
+        );
+        m_window.draw(s);
+        m_window.display();
+    }
 
     // Init other modules
     I18n::getInstance().setDataPath(resources_dir + "/lang");
     MessageSystem::setFont(Resources::getFont("Vera.ttf"));
 
-    // Load XML resources
-    std::cout << "* loading " << XML_LEVELS << "..." << std::endl;
-    LevelManager::getInstance().loadLevelFile(resources_dir + XML_LEVELS);
+    // Load XML resources, files which don't depend on each other are loaded concurrently
+    LevelManager& levels = LevelManager::getInstance();
+    ItemManager& items = ItemManager::getInstance();
+    EntityManager& entities = EntityManager::getInstance();
+    TaskGraph tasks;
 
-    std::cout << "* loading " << XML_UPGRADES << "..." << std::endl;
-    ItemManager::getInstance().loadFromXML(resources_dir + XML_UPGRADES);
+    tasks.add(load_file(resources_dir, XML_LEVELS, [&](const std::string& path) { levels.loadLevelFile(path); }));
+    tasks.add(load_file(resources_dir, XML_UPGRADES, [&](const std::string& path) { items.loadFromXML(path); }));
+    TaskGraph::TaskID weapons = tasks.add(load_file(resources_dir, XML_WEAPONS, [&](const std::string& path) { entities.loadWeapons(path); }));
+    TaskGraph::TaskID animations = tasks.add(load_file(resources_dir, XML_ANIMATIONS, [&](const std::string& path) { entities.loadAnimations(path); }));
 
-    std::cout << "* loading " << XML_WEAPONS << "..." << std::endl;
-    EntityManager::getInstance().loadWeapons(resources_dir + XML_WEAPONS);
+    // Spaceships refer to weapons and animations
+    tasks.add(load_file(resources_dir, XML_SPACESHIPS, [&](const std::string& path) { entities.loadSpaceships(path); }), {weapons, animations});
+    tasks.add(load_file(resources_dir, XML_SOUNDS, SoundSystem::loadSoundProfiles));
+
+    Resources::ConcurrentLoading scope;
+    tasks.run();
+}
 
-    std::cout << "* loading " << XML_ANIMATIONS << "..." << std::endl;
-    EntityManager::getInstance().loadAnimations(resources_dir + XML_ANIMATIONS);
 
-    std::cout << "* loading " << XML_SPACESHIPS << "..." << std::endl;
-    EntityManager::getInstance().loadSpaceships(resources_dir + XML_SPACESHIPS);
+void Game::setHeadless(bool headless)
+{
+    m_headless = headless;
 }
 
 
@@ -119,8 +181,12 @@ void Game::setConfigFile(const std::string& config_path)
 bool Game::loadConfig()
 {
     IniParser config;
+    const float start = StartupReport::getTime();
     if (config.load(m_config_filename))
     {
+        if (StartupReport::isEnabled())
+            StartupReport::add(StartupReport::DATA_FILE, m_config_filename, filesystem::file_size(m_config_filename), start, StartupReport::getTime());
+
         std::cout << "* loading configuration from " << m_config_filename << std::endl;
         config.seekSection("Window");
 
@@ -167,11 +233,34 @@ void Game::writeConfig() const
 int Game::run()
 {
     // Set the first displayed scene at launch
-    setCurrentScreen(SC_IntroScreen);
+    if (Replay::getMode() == Replay::PLAYING)
+    {
+        startLevel(Replay::getLevel());
+    }
+    else if (m_debug_level > 0)
+    {
+        LevelManager::getInstance().setLastUnlocked(m_debug_level);
+        if (m_debug_start_time > 0 && Replay::getMode() == Replay::RECORDING)
+        {
+            std::cerr << "start time ignored, replays are recorded from the beginning of the level" << std::endl;
+            m_debug_start_time = 0.f;
+        }
+        startLevel(m_debug_level, m_debug_start_time);
+    }
+    else
+    {
+        setCurrentScreen(SC_IntroScreen);
+    }
+
+    if (m_hot_reload)
+        m_level_watcher.watch(LevelManager::getInstance().getLevelFile());
 
     sf::Clock clock;
     while (m_running)
     {
+        if (m_hot_reload && m_level_watcher.hasChanged())
+            reloadLevels();
+
         // Poll events
         sf::Event event;
         while (m_window.pollEvent(event))
@@ -195,6 +284,7 @@ int Game::run()
         // Update the current scene
         m_window.clear();
         m_current_screen->update(clock.restart().asSeconds());
+        SoundSystem::update();
 
         // Display the current scene
         m_current_screen->draw(m_window);
@@ -247,6 +337,35 @@ void Game::setCurrentScreen(ScreenID screen_id)
 }
 
 
+void Game::startLevel(size_t level, float start_time)
+{
+    // Must be called before entities are created, as they use the random generator
+    Replay::beginLevel(level);
+
+    // Load selected level in the level manager
+    LevelManager& levels = LevelManager::getInstance();
+    levels.setCurrent(level);
+    levels.initCurrentLevel();
+
+#ifdef DEBUG
+    printf("level %u (music: %s)\n", (unsigned) levels.getCurrent(), levels.getMusicName());
+    printf(" - available points: %d\n", levels.getTotalPoints());
+    printf(" - entities:         %d\n", (int) levels.getSpawnQueueSize());
+    printf(" - duration:      %02d:%02d\n", (int) levels.getDuration() / 60, (int) levels.getDuration() % 60);
+#endif
+    // Init control panel
+    ControlPanel::getInstance().setGameInfo(
+        I18n::templatize("panel.level", "{level}", levels.getCurrent())
+    );
+    // Init entity manager, recorded levels always start with a new player
+    EntityManager::getInstance().initialize(Replay::getMode() != Replay::OFF);
+    if (start_time > 0)
+        EntityManager::getInstance().seek(start_time);
+    Autopilot::reset();
+    setCurrentScreen(SC_PlayScreen);
+}
+
+
 void Game::unloadScreens()
 {
     for (int i = 0; i < SC_COUNT; ++i)
@@ -261,11 +380,28 @@ void Game::unloadScreens()
 }
 
 
+void Game::setDebugLevel(size_t level, float start_time)
+{
+    m_debug_level = level;
+    m_debug_start_time = start_time;
+}
+
+
+void Game::setHotReload(float restart_time)
+{
+    m_hot_reload = true;
+    m_reload_time = restart_time;
+}
+
+
 void Game::quit()
 {
     m_running = false;
     SoundSystem::stopAll();
-    writeConfig();
+    Replay::endLevel();
+    // Replays and debug levels change player items and unlocked levels, don't save them
+    if (Replay::getMode() != Replay::PLAYING && m_debug_level == 0)
+        writeConfig();
 }
 
 
@@ -291,12 +427,44 @@ void Game::takeScreenshot() const
 }
 
 
+void Game::reloadLevels()
+{
+    LevelManager& levels = LevelManager::getInstance();
+    if (!levels.reloadLevelFile())
+        return;
+
+    // Other levels are parsed when they are started
+    bool playing = m_current_screen != NULL
+        && (m_current_screen == m_screens[SC_PlayScreen] || m_current_screen == m_screens[SC_PauseMenu]);
+    if (!playing)
+        return;
+
+    if (Replay::getMode() != Replay::OFF)
+    {
+        std::cerr << "[levels] current level not reloaded, a replay is in progress" << std::endl;
+        return;
+    }
+
+    if (m_reload_time >= 0)
+    {
+        startLevel(levels.getCurrent(), m_reload_time);
+    }
+    else
+    {
+        // Entities already spawned are kept, replace the next ones
+        levels.initCurrentLevel();
+        levels.skipSpawnQueue(EntityManager::getInstance().getTimer());
+    }
+}
+
+
 void Game::setResolution(const sf::Vector2u& size)
 {
-    if (size == m_window.getSize())
+    if (m_headless || size == m_window.getSize())
         return;
 
     // Create window
+    const float start = StartupReport::getTime();
     m_window.create(sf::VideoMode(size.x, size.y, 16), APP_TITLE, sf::Style::Close);
     sf::View view = sf::View(sf::FloatRect(0, 0, APP_WIDTH, APP_HEIGHT));
     m_window.setView(view);
@@ -314,6 +482,7 @@ void Game::setResolution(const sf::Vector2u& size)
     sf::Image icon = Resources::getTexture("gui/icon.bmp").copyToImage();
     icon.createMaskFromColor(sf::Color(0xff, 0, 0xff));
     m_window.setIcon(icon.getSize().x, icon.getSize().y, icon.getPixelsPtr());
+    StartupReport::add(StartupReport::WINDOW, std::to_string(size.x) + "x" + std::to_string(size.y), 0, start, StartupReport::getTime());
 }
 
 
@@ -2,6 +2,7 @@
 #define GAME_HPP
 
 #include <SFML/Graphics/RenderWindow.hpp>
+#include "utils/FileWatcher.hpp"
 
 class Screen;
 
@@ -39,6 +40,11 @@ public:
 
     void loadResources(const std::string& data_dir);
 
+    /**
+     * Run without render window (must be called before loadResources)
+     */
+    void setHeadless(bool headless);
+
     /**
      * Override location of the configuration file
      * @param config_path: directory of file
@@ -71,6 +77,27 @@ public:
      */
     void setCurrentScreen(ScreenID screen);
 
+    /**
+     * Load a level and switch to the play screen
+     * @param level: level number
+     * @param start_time: time in seconds where the level starts (see EntityManager::seek)
+     */
+    void startLevel(size_t level, float start_time = 0.f);
+
+    /**
+     * Level started at launch instead of the intro screen, for debugging
+     * Configuration isn't saved when a debug level is set.
+     * @param start_time: time in seconds where the level starts
+     */
+    void setDebugLevel(size_t level, float start_time = 0.f);
+
+    /**
+     * Watch the level file, and reload it when it is modified
+     * @param restart_time: if not negative, the current level is restarted at this time
+     * (seconds) when modified, otherwise only its next entities are replaced
+     */
+    void setHotReload(float restart_time);
+
     /**
      * Deallocate loaded screens, except the current one
      */
@@ -101,9 +128,22 @@ private:
      */
     void takeScreenshot() const;
 
+    /**
+     * Reload the modified level file, and update the level being played
+     */
+    void reloadLevels();
+
     sf::RenderWindow m_window;
     bool m_vsync;
     bool m_running;
+    bool m_headless;
+    size_t m_debug_level;
+    float  m_debug_start_time;
+
+    // Level file hot-reload
+    bool        m_hot_reload;
+    float       m_reload_time;
+    FileWatcher m_level_watcher;
 
     // Screens
     Screen* m_screens[SC_COUNT];
@@ -137,6 +137,28 @@ bool Input::isPressed(Action::ID action)
 }
 
 
+uint32_t Input::getPressedState()
+{
+    uint32_t state = 0;
+    for (auto& item: s_pressed)
+    {
+        if (item.second)
+            state |= 1u << item.first;
+    }
+    return state;
+}
+
+
+void Input::setPressedState(uint32_t state)
+{
+    // Restore all actions, including actions without binding
+    for (int i = Action::NONE; i <= Action::VALIDATE; ++i)
+    {
+        s_pressed[static_cast<Action::ID>(i)] = (state >> i) & 1u;
+    }
+}
+
+
 void Input::setKeyBinding(sf::Keyboard::Key key, Action::ID action)
 {
     if (key < sf::Keyboard::KeyCount)
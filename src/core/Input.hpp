@@ -1,6 +1,7 @@
 #ifndef INPUT_HPP
 #define INPUT_HPP
 
+#include <cstdint>
 #include <map>
 #include <SFML/Window.hpp>
 
@@ -54,6 +55,12 @@ public:
      */
     static bool isPressed(Action::ID action);
 
+    /**
+     * Hold down state of all actions, as a bit mask (bit N is set if action N is pressed)
+     */
+    static uint32_t getPressedState();
+    static void setPressedState(uint32_t state);
+
     /**
      * Bind a key to an action
      */
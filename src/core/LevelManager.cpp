@@ -5,15 +5,16 @@
 #include "Resources.hpp"
 #include "entities/EntityManager.hpp"
 #include "entities/Asteroid.hpp"
+#include "entities/EntityFactory.hpp"
 #include "entities/Spaceship.hpp"
-#include "entities/bosses/FlyingSaucerBoss.hpp"
-#include "entities/bosses/EvilBoss.hpp"
-#include "entities/bosses/TentaculatBoss.hpp"
-#include "entities/bosses/BrainBoss.hpp"
-#include "entities/decors/Gate.hpp"
-#include "entities/decors/Canon.hpp"
-#include "entities/decors/GunTower.hpp"
 #include "utils/SFML_Helper.hpp"
+#include "utils/StringUtils.hpp"
+#include "utils/Math.hpp"
+
+// Lowest spawn position in generated levels
+#define STRESS_MAX_Y 360
+// Distance of the decors ahead of the view in generated levels, in pixels
+#define STRESS_DECOR_AHEAD 400
 
 
 LevelManager& LevelManager::getInstance()
@@ -23,6 +24,17 @@ LevelManager& LevelManager::getInstance()
 }
 
 
+LevelManager::StressLevel::StressLevel():
+    duration(120.f),
+    ships_per_second(4.f),
+    asteroids_per_second(1.f),
+    decors_per_second(0.25f),
+    ships("b1,b1c,b2,b2c,b3,s1,s2"),
+    seed(1)
+{
+}
+
+
 LevelManager::LevelManager():
     m_current_level(1),
     m_last_unlocked_level(1),
@@ -47,6 +59,7 @@ void LevelManager::loadLevelFile(const std::string& path)
         throw std::runtime_error(error);
     }
 
+    m_path = path;
     tinyxml2::XMLElement* root = m_xml_doc.RootElement();
 
     // Parse function nodes
@@ -55,7 +68,10 @@ void LevelManager::loadLevelFile(const std::string& path)
     {
         const char* name = node->Attribute("name");
         if (name != NULL)
+        {
             m_functions[name] = node;
+            m_function_hashes[name] = hashNode(node);
+        }
         else
             std::cerr << "[levels] a function without a name has been ignored" << std::endl;
         node = node->NextSiblingElement();
@@ -66,11 +82,155 @@ void LevelManager::loadLevelFile(const std::string& path)
     while (node != NULL)
     {
         m_levels.push_back(node);
+        m_level_hashes.push_back(hashNode(node));
         node = node->NextSiblingElement("level");
     }
 }
 
 
+bool LevelManager::reloadLevelFile()
+{
+    tinyxml2::XMLDocument doc;
+    if (doc.LoadFile(m_path.c_str()) != 0)
+    {
+        std::cerr << "[levels] cannot reload levels from " << m_path << ": " << doc.GetErrorStr1() << std::endl;
+        return false;
+    }
+    const tinyxml2::XMLElement* root = doc.RootElement();
+    const tinyxml2::XMLElement* functions = root != NULL ? root->FirstChildElement("functions") : NULL;
+    const tinyxml2::XMLElement* levels = root != NULL ? root->FirstChildElement("levels") : NULL;
+    if (functions == NULL || levels == NULL)
+    {
+        std::cerr << "[levels] cannot reload levels from " << m_path << ": 'functions' or 'levels' node missing" << std::endl;
+        return false;
+    }
+
+    // Validate the document before modifying anything, the file may be saved while being edited
+    for (const tinyxml2::XMLElement* node = functions->FirstChildElement(); node != NULL; node = node->NextSiblingElement())
+    {
+        if (node->Attribute("name") == NULL)
+        {
+            std::cerr << "[levels] cannot reload levels from " << m_path << ": a function has no name" << std::endl;
+            return false;
+        }
+    }
+    if (levels->FirstChildElement("level") == NULL)
+    {
+        std::cerr << "[levels] cannot reload levels from " << m_path << ": no level found" << std::endl;
+        return false;
+    }
+
+    // Replace modified functions, and remember their names
+    std::set<std::string> changed_functions;
+    std::map<std::string, uint32_t> function_hashes;
+    tinyxml2::XMLElement* functions_node = m_xml_doc.RootElement()->FirstChildElement("functions");
+    for (const tinyxml2::XMLElement* node = functions->FirstChildElement(); node != NULL; node = node->NextSiblingElement())
+    {
+        const char* name = node->Attribute("name");
+        uint32_t hash = hashNode(node);
+        function_hashes[name] = hash;
+        std::map<std::string, uint32_t>::const_iterator previous = m_function_hashes.find(name);
+        if (previous == m_function_hashes.end() || previous->second != hash)
+        {
+            changed_functions.insert(name);
+            tinyxml2::XMLNode* clone = cloneNode(node);
+            NodeMap::iterator it = m_functions.find(name);
+            if (it != m_functions.end())
+            {
+                functions_node->InsertAfterChild(it->second, clone);
+                functions_node->DeleteChild(it->second);
+            }
+            else
+            {
+                functions_node->InsertEndChild(clone);
+            }
+            m_functions[name] = clone->ToElement();
+        }
+    }
+    // Removed functions
+    for (NodeMap::iterator it = m_functions.begin(); it != m_functions.end();)
+    {
+        if (function_hashes.find(it->first) == function_hashes.end())
+        {
+            changed_functions.insert(it->first);
+            functions_node->DeleteChild(it->second);
+            m_functions.erase(it++);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    m_function_hashes.swap(function_hashes);
+
+    // Replace modified levels, levels are identified by their position
+    std::vector<bool> changed_levels;
+    std::vector<uint32_t> level_hashes;
+    tinyxml2::XMLElement* levels_node = m_xml_doc.RootElement()->FirstChildElement("levels");
+    for (const tinyxml2::XMLElement* node = levels->FirstChildElement("level"); node != NULL; node = node->NextSiblingElement("level"))
+    {
+        const size_t index = level_hashes.size();
+        uint32_t hash = hashNode(node);
+        level_hashes.push_back(hash);
+        if (index < m_level_hashes.size() && m_level_hashes[index] == hash)
+        {
+            changed_levels.push_back(false);
+            continue;
+        }
+
+        tinyxml2::XMLNode* clone = cloneNode(node);
+        if (index < m_level_hashes.size())
+        {
+            levels_node->InsertAfterChild(m_levels[index], clone);
+            levels_node->DeleteChild(m_levels[index]);
+            m_levels[index] = clone->ToElement();
+        }
+        else
+        {
+            // New level, inserted before the generated levels
+            if (index > 0)
+                levels_node->InsertAfterChild(m_levels[index - 1], clone);
+            else
+                levels_node->InsertFirstChild(clone);
+            m_levels.insert(m_levels.begin() + index, clone->ToElement());
+        }
+        changed_levels.push_back(true);
+    }
+    // Removed levels
+    for (size_t index = m_level_hashes.size(); index > level_hashes.size(); --index)
+    {
+        levels_node->DeleteChild(m_levels[index - 1]);
+        m_levels.erase(m_levels.begin() + index - 1);
+    }
+    m_level_hashes.swap(level_hashes);
+
+    if (m_last_unlocked_level > m_levels.size())
+        m_last_unlocked_level = m_levels.size();
+    if (m_current_level > m_levels.size())
+        m_current_level = 1;
+
+    // Levels calling a modified function are modified too
+    changed_levels.resize(m_levels.size(), false);
+    int count = 0;
+    for (size_t i = 0; i < m_levels.size(); ++i)
+    {
+        if (!changed_levels[i] && !changed_functions.empty())
+            changed_levels[i] = callsFunction(m_levels[i], changed_functions);
+        if (changed_levels[i])
+            ++count;
+    }
+    std::cout << "* levels reloaded: " << count << " level(s) and " << changed_functions.size() << " function(s) modified" << std::endl;
+
+    return changed_levels[m_current_level - 1];
+}
+
+
+const std::string& LevelManager::getLevelFile() const
+{
+    return m_path;
+}
+
+
 void LevelManager::initCurrentLevel()
 {
     resetSpawnQueue();
@@ -102,6 +262,16 @@ size_t LevelManager::getSpawnQueueSize() const
 }
 
 
+void LevelManager::skipSpawnQueue(float elapsed_time)
+{
+    while (!m_spawn_queue.empty() && m_spawn_queue.front().spawntime < elapsed_time)
+    {
+        delete m_spawn_queue.front().entity;
+        m_spawn_queue.pop();
+    }
+}
+
+
 void LevelManager::setCurrent(size_t level)
 {
     if (level < 1 || level > m_last_unlocked_level || level > m_levels.size())
@@ -152,6 +322,82 @@ size_t LevelManager::getLevelCount() const
 }
 
 
+size_t LevelManager::addStressLevel(const StressLevel& params)
+{
+    static const char* MOVEMENTS[] = {"line", "magnet", "sinus", "circle"};
+    static const char* ATTACKS[] = {"auto_aim", "on_sight"};
+
+    tinyxml2::XMLElement* level = m_xml_doc.NewElement("level");
+    level->SetAttribute("layer1", "layers/blue.jpg");
+    level->SetAttribute("layer2", "layers/fog.png");
+    level->SetAttribute("color", "#002060");
+    level->SetAttribute("stars", 30);
+    level->SetAttribute("music", "tempested.mod");
+
+    std::vector<std::string> ships = utils::split(params.ships, ',');
+    math::Random random(params.seed);
+    float ship_delay = params.ships_per_second > 0 ? 1.f / params.ships_per_second : params.duration;
+    float asteroid_delay = params.asteroids_per_second > 0 ? 1.f / params.asteroids_per_second : params.duration;
+    float decor_delay = params.decors_per_second > 0 ? 1.f / params.decors_per_second : params.duration;
+    float next_ship = ships.empty() ? params.duration : 0.f;
+    float next_asteroid = params.asteroids_per_second > 0 ? 0.f : params.duration;
+    float next_decor = params.decors_per_second > 0 ? 0.f : params.duration;
+    float last_time = 0.f;
+    size_t ship_index = 0;
+
+    // Merge ship, asteroid and decor spawns, 't' attributes are delays since the previous entity
+    while (next_ship < params.duration || next_asteroid < params.duration || next_decor < params.duration)
+    {
+        tinyxml2::XMLElement* entity;
+        float time;
+        if (next_decor < next_ship && next_decor < next_asteroid)
+        {
+            // Gun towers are always at the bottom, they don't use the random generator
+            entity = m_xml_doc.NewElement("decor");
+            entity->SetAttribute("id", "guntower");
+            entity->SetAttribute("x", APP_WIDTH + STRESS_DECOR_AHEAD);
+            entity->SetAttribute("t", next_decor - last_time);
+            last_time = next_decor;
+            next_decor += decor_delay;
+            level->InsertEndChild(entity);
+            continue;
+        }
+        if (next_ship <= next_asteroid)
+        {
+            entity = m_xml_doc.NewElement("ship");
+            entity->SetAttribute("id", ships[ship_index++ % ships.size()].c_str());
+            entity->SetAttribute("move", MOVEMENTS[random.rand(0, 3)]);
+            entity->SetAttribute("attack", ATTACKS[random.rand(0, 1)]);
+            time = next_ship;
+            next_ship += ship_delay;
+        }
+        else
+        {
+            entity = m_xml_doc.NewElement("asteroid");
+            time = next_asteroid;
+            next_asteroid += asteroid_delay;
+        }
+        entity->SetAttribute("y", random.rand(10, STRESS_MAX_Y));
+        entity->SetAttribute("t", time - last_time);
+        last_time = time;
+        level->InsertEndChild(entity);
+    }
+
+    if (!params.boss.empty())
+    {
+        tinyxml2::XMLElement* boss = m_xml_doc.NewElement("boss");
+        boss->SetAttribute("id", params.boss.c_str());
+        boss->SetAttribute("y", 100);
+        boss->SetAttribute("t", 5);
+        level->InsertEndChild(boss);
+    }
+
+    m_xml_doc.RootElement()->FirstChildElement("levels")->InsertEndChild(level);
+    m_levels.push_back(level);
+    return m_levels.size();
+}
+
+
 const sf::Texture* LevelManager::getBottomLayer() const
 {
     const char* p = getCurrentLevelElement()->Attribute("layer1");
@@ -273,11 +519,31 @@ void LevelManager::parseEntities(const tinyxml2::XMLElement* elem)
         {
             // Get spaceship profile id
             const char* id = elem->Attribute("id");
-            if (id != NULL)
+            int profile_id = id != NULL ? EntityManager::getInstance().getSpaceshipProfileID(id) : -1;
+            if (profile_id != -1)
             {
-                Spaceship* spaceship = EntityManager::getInstance().createSpaceship(id);
-                if (spaceship != NULL)
-                    m_total_points += spaceship->getPoints();
+                Spaceship* spaceship = EntityManager::getInstance().createSpaceship(profile_id);
+                m_total_points += spaceship->getPoints();
+
+                // Optional patterns, overriding the spaceship profile
+                Spaceship::MovementPattern movement;
+                if (Spaceship::parseMovementPattern(elem->Attribute("move"), movement))
+                    spaceship->setMovementPattern(movement);
+                else if (elem->Attribute("move") != NULL)
+                    std::cerr << "[levels] unknown movement pattern '" << elem->Attribute("move") << "' ignored" << std::endl;
+
+                Spaceship::AttackPattern attack;
+                if (Spaceship::parseAttackPattern(elem->Attribute("attack"), attack))
+                {
+                    if (spaceship->getWeapon().isInitialized() || attack == Spaceship::NONE)
+                        spaceship->setAttackPattern(attack);
+                    else
+                        std::cerr << "[levels] spaceship '" << id << "' has no weapon, attack pattern ignored" << std::endl;
+                }
+                else if (elem->Attribute("attack") != NULL)
+                {
+                    std::cerr << "[levels] unknown attack pattern '" << elem->Attribute("attack") << "' ignored" << std::endl;
+                }
 
                 entity = spaceship;
             }
@@ -286,26 +552,15 @@ void LevelManager::parseEntities(const tinyxml2::XMLElement* elem)
         {
             entity = new Asteroid(Asteroid::BIG);
         }
-        else if (strcmp(tag_name, "boss") == 0)
-        {
-            if      (elem->Attribute("id", "tentaculat"))    entity = new TentaculatBoss();
-            else if (elem->Attribute("id", "flying-saucer")) entity = new FlyingSaucerBoss();
-            else if (elem->Attribute("id", "brain"))         entity = new BrainBoss();
-            else if (elem->Attribute("id", "evil"))          entity = new EvilBoss();
-            else
-                std::cerr << "[levels] unknown boss id '" << elem->Attribute("id") << "' ignored" << std::endl;
-        }
-        else if (strcmp(tag_name, "decor") == 0)
-        {
-            if      (elem->Attribute("id", "gate"))      entity = new Gate();
-            else if (elem->Attribute("id", "canon"))     entity = new Canon();
-            else if (elem->Attribute("id", "guntower"))  entity = new GunTower();
-            else
-                std::cerr << "[levels] unknown decor id '" << elem->Attribute("id") << "' ignored" << std::endl;
-        }
         else
         {
-            std::cerr << "[levels] unknown tag '" << tag_name << "' ignored" << std::endl;
+            // Other entities are created by the factory, from their tag and id
+            const char* id = elem->Attribute("id");
+            int kind = id != NULL ? EntityFactory::getInstance().find(tag_name, id) : -1;
+            if (kind != -1)
+                entity = EntityFactory::getInstance().create(kind);
+            else
+                std::cerr << "[levels] unknown tag '" << tag_name << "' with id '" << (id != NULL ? id : "") << "' ignored" << std::endl;
         }
 
         if (entity != NULL)
@@ -349,3 +604,50 @@ const tinyxml2::XMLElement* LevelManager::getCurrentLevelElement() const
 {
     return m_levels.at(m_current_level - 1);
 }
+
+
+uint32_t LevelManager::hashNode(const tinyxml2::XMLElement* elem)
+{
+    tinyxml2::XMLPrinter printer(NULL, true);
+    elem->Accept(&printer);
+    // CStrSize includes the null terminator
+    return utils::hash_buffer(printer.CStr(), printer.CStrSize() - 1);
+}
+
+
+tinyxml2::XMLNode* LevelManager::cloneNode(const tinyxml2::XMLNode* node)
+{
+    tinyxml2::XMLNode* clone = node->ShallowClone(&m_xml_doc);
+    for (const tinyxml2::XMLNode* child = node->FirstChild(); child != NULL; child = child->NextSibling())
+    {
+        clone->InsertEndChild(cloneNode(child));
+    }
+    return clone;
+}
+
+
+bool LevelManager::callsFunction(const tinyxml2::XMLElement* elem, const std::set<std::string>& functions, int depth) const
+{
+    // Prevent infinite recursion on functions calling themselves
+    if (depth > 16)
+        return false;
+
+    for (const tinyxml2::XMLElement* child = elem->FirstChildElement(); child != NULL; child = child->NextSiblingElement())
+    {
+        if (strcmp(child->Value(), "call") == 0 && child->Attribute("func") != NULL)
+        {
+            const char* func_name = child->Attribute("func");
+            if (functions.count(func_name) > 0)
+                return true;
+
+            NodeMap::const_iterator it = m_functions.find(func_name);
+            if (it != m_functions.end() && callsFunction(it->second, functions, depth + 1))
+                return true;
+        }
+        else if (callsFunction(child, functions, depth))
+        {
+            return true;
+        }
+    }
+    return false;
+}
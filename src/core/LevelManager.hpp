@@ -1,8 +1,10 @@
 #ifndef LEVELMANAGER_HPP
 #define LEVELMANAGER_HPP
 
+#include <cstdint>
 #include <queue>
 #include <map>
+#include <set>
 #include <string>
 #include <SFML/Graphics.hpp>
 
@@ -20,9 +22,24 @@ public:
 
     /**
      * Load the XML file storing the levels definitions
+     * The document is kept in memory: levels are parsed when they start (see
+     * initCurrentLevel), and nodes are replaced on reload.
      */
     void loadLevelFile(const std::string& path);
 
+    /**
+     * Load the level file again, after it has been modified
+     * Only the level and function nodes which changed are replaced, the spawn
+     * queue isn't modified (see initCurrentLevel).
+     * @return true if the current level definition changed
+     */
+    bool reloadLevelFile();
+
+    /**
+     * Path of the loaded level file
+     */
+    const std::string& getLevelFile() const;
+
     /**
      * Parse the current level definition and allocate entities in the spawn queue
      */
@@ -41,6 +58,12 @@ public:
      */
     size_t getSpawnQueueSize() const;
 
+    /**
+     * Delete the entities of the spawn queue spawning before a given time
+     * @param elapsed_time: elapsed time in seconds in the level
+     */
+    void skipSpawnQueue(float elapsed_time);
+
     /**
      * Set the current level
      * @param level: level number, between 1 and getLastUnlocked()
@@ -56,6 +79,30 @@ public:
     void setLastUnlocked(size_t level);
     size_t getLastUnlocked() const;
 
+    /**
+     * Settings of a generated stress level
+     */
+    struct StressLevel
+    {
+        StressLevel();
+
+        float       duration;             // Time of the last spawned entity, in seconds
+        float       ships_per_second;
+        float       asteroids_per_second;
+        float       decors_per_second;    // Gun towers, spawned ahead of the view
+        std::string ships;                // Comma-separated spaceship ids, used in turn
+        std::string boss;                 // Boss spawned at the end, if not empty
+        uint32_t    seed;                 // Seed for spawn positions and patterns
+    };
+
+    /**
+     * Generate a level with many spaceships and asteroids, with random movement
+     * and attack patterns, for measuring engine performance
+     * Gun towers are placed ahead of the view, they sleep until they scroll into it.
+     * @return number of the new level
+     */
+    size_t addStressLevel(const StressLevel& params);
+
     /**
      * Get number of levels available
      */
@@ -116,12 +163,31 @@ private:
      */
     const tinyxml2::XMLElement* getCurrentLevelElement() const;
 
-    typedef std::vector<const tinyxml2::XMLElement*> NodeVector;
-    typedef std::map<std::string, const tinyxml2::XMLElement*> NodeMap;
+    /**
+     * Hash of the XML content of a node, for detecting modified nodes
+     */
+    static uint32_t hashNode(const tinyxml2::XMLElement* elem);
+
+    /**
+     * Copy a node and its children from another document into the level document
+     */
+    tinyxml2::XMLNode* cloneNode(const tinyxml2::XMLNode* node);
+
+    /**
+     * @return true if elem, or one of its children, calls one of the given functions
+     */
+    bool callsFunction(const tinyxml2::XMLElement* elem, const std::set<std::string>& functions, int depth = 0) const;
+
+    typedef std::vector<tinyxml2::XMLElement*> NodeVector;
+    typedef std::map<std::string, tinyxml2::XMLElement*> NodeMap;
 
     tinyxml2::XMLDocument m_xml_doc;
+    std::string           m_path;
     NodeVector            m_levels; // Ordered array of level nodes
     NodeMap               m_functions; // Function nodes, indexed by their name
+    // Hashes of the nodes loaded from the level file (generated levels excluded)
+    std::vector<uint32_t>           m_level_hashes;
+    std::map<std::string, uint32_t> m_function_hashes;
     size_t                m_current_level;
     size_t                m_last_unlocked_level;
 
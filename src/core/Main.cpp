@@ -1,6 +1,14 @@
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include "Autopilot.hpp"
+#include "Benchmark.hpp"
 #include "Game.hpp"
+#include "LevelManager.hpp"
+#include "Replay.hpp"
+#include "StartupReport.hpp"
+#include "utils/I18n.hpp"
+#include "utils/Math.hpp"
 
 #include "Constants.hpp"
 
@@ -13,10 +21,26 @@ int usage(const char *pn)
     if (n == NULL)
         n = strrchr(pn, '\\'); // Windows systems
 
-    printf("usage: %s [-c config_file] [-r resources_dir] [-h] [-v]\n\n", n == NULL ? pn : n + 1);
+    printf("usage: %s [-c config_file] [-r resources_dir] [-s seed] [-record file | -replay file] [-autopilot] [-bench report] [-stress ships_per_second] [-level number] [-start-at seconds] [-hot-reload] [-reload-at seconds] [-startup-report file] [-h] [-v]\n\n", n == NULL ? pn : n + 1);
     puts("If config_file is a directory, the game will look for a configuration file named");
     puts("\42cosmoscroll.ini\42 (or create it if it doesn't exist).");
     puts("If it is a regular file, it will use it as an alternate configuration file.");
+    puts("The random seed defaults to the current time, use the same seed to reproduce a game.");
+    puts("-record saves the last level played to a replay file, -replay plays it back.");
+    puts("-autopilot lets a scripted pilot play instead of you.");
+    puts("-bench plays all levels without window and writes a JSON performance report, level N");
+    puts("is played with the replay file \42level-N.replay\42 from the report directory if it exists,");
+    puts("or by the autopilot otherwise. Memory allocations are only counted by the benchmark");
+    puts("build (make bench), they are reported as 0 otherwise.");
+    puts("-stress generates a level with the given number of spaceships per second and starts it");
+    puts("(or adds it to the benchmark), see also tools/gen_stress_level.py.");
+    puts("-level starts the given level at launch, -start-at starts it at the given time (in");
+    puts("seconds): the last seconds before are simulated at once, without rendering.");
+    puts("With -bench, they restrict the benchmark to a segment of a level.");
+    puts("-hot-reload reloads the level file when it is modified, -reload-at also restarts the");
+    puts("current level at the given time (in seconds) when it is modified.");
+    puts("-startup-report writes a JSON report of the time spent loading files, textures, fonts");
+    puts("and sounds, and creating the window.");
     return EXIT_SUCCESS;
 }
 
@@ -45,6 +69,14 @@ int main(int argc, char* argv[])
     // default values
     std::string config_file = "";
     std::string res_dir = DEFAULT_RESOURCES_DIR;
+    std::string replay_file = "";
+    std::string bench_file = "";
+    float stress_rate = 0.f;
+    size_t debug_level = 0;
+    float start_time = 0.f;
+    bool hot_reload = false;
+    float reload_time = -1.f;
+    std::string startup_report = "";
 
     // parse args
     for (int i = 0; i < argc; ++i)
@@ -58,7 +90,36 @@ int main(int argc, char* argv[])
             config_file = get_arg(i, argv);
         else if (arg == "-r" || arg == "-res")
             res_dir = get_arg(i, argv);
+        else if (arg == "-s" || arg == "-seed")
+            math::set_seed(strtoul(get_arg(i, argv), NULL, 10));
+        else if (arg == "-record")
+            Replay::setRecordFile(get_arg(i, argv));
+        else if (arg == "-replay")
+            replay_file = get_arg(i, argv);
+        else if (arg == "-autopilot")
+            Autopilot::setEnabled(true);
+        else if (arg == "-bench")
+            bench_file = get_arg(i, argv);
+        else if (arg == "-stress")
+            stress_rate = strtod(get_arg(i, argv), NULL);
+        else if (arg == "-level")
+            debug_level = strtoul(get_arg(i, argv), NULL, 10);
+        else if (arg == "-start-at")
+            start_time = strtod(get_arg(i, argv), NULL);
+        else if (arg == "-hot-reload")
+            hot_reload = true;
+        else if (arg == "-reload-at")
+        {
+            hot_reload = true;
+            reload_time = strtod(get_arg(i, argv), NULL);
+        }
+        else if (arg == "-startup-report")
+        {
+            startup_report = get_arg(i, argv);
+            StartupReport::setEnabled(true);
+        }
     }
+    printf("* random seed: %u\n", math::seed);
 
     Game& game = Game::getInstance();
     game.init(argv[0]);
@@ -66,7 +127,36 @@ int main(int argc, char* argv[])
     {
         game.setConfigFile(config_file);
     }
+    game.setHeadless(!bench_file.empty());
     game.loadResources(res_dir);
+    if (stress_rate > 0)
+    {
+        LevelManager::StressLevel params;
+        params.ships_per_second = stress_rate;
+        params.asteroids_per_second = stress_rate / 4;
+        size_t level = LevelManager::getInstance().addStressLevel(params);
+        printf("* stress level %u: %g ships/s\n", (unsigned) level, stress_rate);
+        game.setDebugLevel(level, start_time);
+    }
+    else if (debug_level > 0 || start_time > 0)
+    {
+        game.setDebugLevel(debug_level > 0 ? debug_level : 1, start_time);
+    }
+    if (!bench_file.empty())
+    {
+        // Ignore user configuration, so reports are comparable
+        I18n::getInstance().loadFromLocale();
+        if (!startup_report.empty())
+            StartupReport::write(startup_report);
+        return Benchmark::run(bench_file, debug_level, start_time);
+    }
     game.loadConfig();
+    if (!startup_report.empty())
+        StartupReport::write(startup_report);
+    if (hot_reload)
+        game.setHotReload(reload_time);
+    if (!replay_file.empty() && !Replay::loadFromFile(replay_file))
+        return EXIT_FAILURE;
+
     return game.run();
 }
@@ -149,15 +149,17 @@ void ParticleEmitter::resetParticle(ParticleSystem::Particle& particle) const
     particle.position.x = m_position.x - m_texture_rect.width / 2;
     particle.position.y =  m_position.y - m_texture_rect.height / 2;
 
+    math::Random& random = math::random(math::PARTICLES);
+
     // Set random angle
-    particle.angle = math::rand(m_angle - m_angle_variation, m_angle + m_angle_variation);
+    particle.angle = random.rand(m_angle - m_angle_variation, m_angle + m_angle_variation);
 
     // Set random velocity vector
-    float speed = math::rand(m_speed - m_speed_variation, m_speed + m_speed_variation);
+    float speed = random.rand(m_speed - m_speed_variation, m_speed + m_speed_variation);
     particle.velocity = sf::Vector2f(speed * std::cos(particle.angle), speed * -std::sin(particle.angle));
 
     // Set random lifetime
-    particle.lifespan = m_lifetime == 0.f ? 0.f : math::rand(0.f, m_lifetime);
+    particle.lifespan = m_lifetime == 0.f ? 0.f : random.rand(0.f, m_lifetime);
     particle.elapsed = 0.f;
 
     onParticleCreated(particle);
@@ -144,6 +144,12 @@ void ParticleSystem::update(float frametime)
 }
 
 
+size_t ParticleSystem::getParticleCount() const
+{
+    return m_particles.size();
+}
+
+
 void ParticleSystem::clear()
 {
     m_particles.clear();
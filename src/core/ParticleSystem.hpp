@@ -72,6 +72,11 @@ public:
      */
     void clear();
 
+    /**
+     * Number of living particles
+     */
+    size_t getParticleCount() const;
+
 private:
     ParticleSystem();
     ~ParticleSystem();
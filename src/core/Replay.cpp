@@ -0,0 +1,240 @@
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include "Replay.hpp"
+#include "LevelManager.hpp"
+#include "UserSettings.hpp"
+#include "entities/Player.hpp"
+#include "utils/Math.hpp"
+
+// Replay file layout (integers are little-endian):
+//   header: magic (4 bytes), version, seed, level, frame count (u32 each), 20 bytes in total
+//   items:  item levels, one u8 per item type (Item::_COUNT bytes)
+//   frames: frame time (f32), actions state (u16), event count (u8), events (u8 each),
+//           7 bytes per frame plus one byte per event
+#define REPLAY_MAGIC   "CSRI"
+#define REPLAY_VERSION 1
+#define EVENT_PRESSED  0x80
+
+Replay::Mode                 Replay::s_mode = Replay::OFF;
+std::string                  Replay::s_filename;
+uint32_t                     Replay::s_seed = 0;
+uint32_t                     Replay::s_level = 0;
+std::vector<uint8_t>         Replay::s_items;
+std::vector<Replay::Frame>   Replay::s_frames;
+std::vector<uint8_t>         Replay::s_events;
+uint32_t                     Replay::s_pending_events = 0;
+size_t                       Replay::s_current_frame = 0;
+size_t                       Replay::s_current_event = 0;
+float                        Replay::s_elapsed = 0.f;
+bool                         Replay::s_saved = true;
+
+
+static void write_u32(std::ostream& out, uint32_t value)
+{
+    const char bytes[4] = {char(value), char(value >> 8), char(value >> 16), char(value >> 24)};
+    out.write(bytes, 4);
+}
+
+
+static uint32_t read_u32(std::istream& in)
+{
+    unsigned char bytes[4] = {0, 0, 0, 0};
+    in.read(reinterpret_cast<char*>(bytes), 4);
+    return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (uint32_t(bytes[3]) << 24);
+}
+
+
+void Replay::setRecordFile(const std::string& filename)
+{
+    s_filename = filename;
+    s_mode = RECORDING;
+}
+
+
+bool Replay::loadFromFile(const std::string& filename)
+{
+    std::ifstream file(filename.c_str(), std::ios::binary);
+    char magic[4] = {0};
+    file.read(magic, 4);
+    if (!file || std::memcmp(magic, REPLAY_MAGIC, 4) != 0 || read_u32(file) != REPLAY_VERSION)
+    {
+        std::cerr << "[Replay] " << filename << " is not a valid replay file" << std::endl;
+        return false;
+    }
+
+    s_seed = read_u32(file);
+    s_level = read_u32(file);
+    uint32_t frame_count = read_u32(file);
+    s_items.assign(Item::_COUNT, 0);
+    file.read(reinterpret_cast<char*>(&s_items[0]), Item::_COUNT);
+
+    s_frames.clear();
+    s_events.clear();
+    for (uint32_t i = 0; i < frame_count && file; ++i)
+    {
+        Frame frame;
+        uint32_t frametime = read_u32(file);
+        std::memcpy(&frame.frametime, &frametime, sizeof (float));
+        frame.pressed = file.get();
+        frame.pressed |= file.get() << 8;
+        frame.event_count = file.get();
+        for (uint32_t j = 0; j < frame.event_count; ++j)
+            s_events.push_back(file.get());
+
+        s_frames.push_back(frame);
+    }
+    if (!file)
+    {
+        std::cerr << "[Replay] " << filename << " is truncated" << std::endl;
+        return false;
+    }
+
+    s_filename = filename;
+    s_mode = PLAYING;
+    std::cout << "* replaying level " << s_level << " (" << s_frames.size() << " frames)" << std::endl;
+    return true;
+}
+
+
+void Replay::reset()
+{
+    s_mode = OFF;
+    s_saved = true;
+}
+
+
+Replay::Mode Replay::getMode()
+{
+    return s_mode;
+}
+
+
+size_t Replay::getLevel()
+{
+    return s_level;
+}
+
+
+void Replay::beginLevel(size_t level)
+{
+    if (s_mode == RECORDING)
+    {
+        // Reset the random generator, so the level doesn't depend on previous levels
+        s_seed = math::seed;
+        s_level = level;
+        s_items.clear();
+        for (int i = 0; i < Item::_COUNT; ++i)
+            s_items.push_back(UserSettings::getItemLevel(static_cast<Item::Type>(i)));
+
+        s_frames.clear();
+        s_events.clear();
+        s_pending_events = 0;
+        s_saved = false;
+    }
+    else if (s_mode == PLAYING)
+    {
+        for (int i = 0; i < Item::_COUNT; ++i)
+            UserSettings::setItemLevel(static_cast<Item::Type>(i), s_items[i]);
+
+        // The recorded level may still be locked in the current configuration
+        LevelManager& levels = LevelManager::getInstance();
+        if (levels.getLastUnlocked() < level)
+            levels.setLastUnlocked(level);
+
+        s_current_frame = 0;
+        s_current_event = 0;
+        s_elapsed = 0.f;
+    }
+    else
+    {
+        return;
+    }
+    math::set_seed(s_seed);
+}
+
+
+void Replay::endLevel()
+{
+    if (s_mode == RECORDING && !s_saved)
+    {
+        std::ofstream file(s_filename.c_str(), std::ios::binary);
+        file.write(REPLAY_MAGIC, 4);
+        write_u32(file, REPLAY_VERSION);
+        write_u32(file, s_seed);
+        write_u32(file, s_level);
+        write_u32(file, s_frames.size());
+        file.write(reinterpret_cast<const char*>(&s_items[0]), s_items.size());
+
+        const uint8_t* events = s_events.empty() ? NULL : &s_events[0];
+        for (const Frame& frame: s_frames)
+        {
+            uint32_t frametime;
+            std::memcpy(&frametime, &frame.frametime, sizeof (float));
+            write_u32(file, frametime);
+            file.put(frame.pressed & 0xff);
+            file.put(frame.pressed >> 8);
+            file.put(frame.event_count);
+            file.write(reinterpret_cast<const char*>(events), frame.event_count);
+            events += frame.event_count;
+        }
+
+        if (file)
+            std::cout << "* level " << s_level << " recorded to " << s_filename << " (" << s_frames.size() << " frames)" << std::endl;
+        else
+            std::cerr << "[Replay] cannot write " << s_filename << std::endl;
+        s_saved = true;
+    }
+    else if (s_mode == PLAYING)
+    {
+        std::cout << "* replay over: " << s_current_frame << "/" << s_frames.size() << " frames, "
+                  << s_elapsed << "s of game time" << std::endl;
+    }
+}
+
+
+void Replay::recordAction(Action::ID action, bool pressed)
+{
+    // Event count is stored on 8 bits
+    if (s_mode == RECORDING && !s_saved && action != Action::NONE && s_pending_events < 0xff)
+    {
+        s_events.push_back(pressed ? action | EVENT_PRESSED : action);
+        ++s_pending_events;
+    }
+}
+
+
+void Replay::recordFrame(float frametime)
+{
+    if (s_mode == RECORDING && !s_saved)
+    {
+        Frame frame;
+        frame.frametime = frametime;
+        frame.pressed = Input::getPressedState();
+        frame.event_count = s_pending_events;
+        s_frames.push_back(frame);
+        s_pending_events = 0;
+    }
+}
+
+
+bool Replay::playFrame(float& frametime, Player& player)
+{
+    if (s_current_frame >= s_frames.size())
+        return false;
+
+    const Frame& frame = s_frames[s_current_frame++];
+    for (uint32_t i = 0; i < frame.event_count; ++i)
+    {
+        uint8_t event = s_events[s_current_event++];
+        Action::ID action = static_cast<Action::ID>(event & ~EVENT_PRESSED);
+        if (event & EVENT_PRESSED)
+            player.onActionDown(action);
+        else
+            player.onActionUp(action);
+    }
+    Input::setPressedState(frame.pressed);
+    frametime = frame.frametime;
+    s_elapsed += frametime;
+    return true;
+}
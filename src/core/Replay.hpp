@@ -0,0 +1,104 @@
+#ifndef REPLAY_HPP
+#define REPLAY_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Input.hpp"
+
+class Player;
+
+/**
+ * Static class for recording a level session and playing it back frame-exactly
+ * A replay stores the random seed, the level number, the player items and, for each
+ * frame, the frame time, the actions state and the actions sent to the player.
+ */
+class Replay
+{
+public:
+    enum Mode
+    {
+        OFF,
+        RECORDING,
+        PLAYING
+    };
+
+    /**
+     * Record the levels played to a file (the last recorded level is kept)
+     */
+    static void setRecordFile(const std::string& filename);
+
+    /**
+     * Load a replay file and enter playing mode
+     * @return false if file cannot be loaded
+     */
+    static bool loadFromFile(const std::string& filename);
+
+    /**
+     * Leave recording or playing mode (current recording is discarded)
+     */
+    static void reset();
+
+    static Mode getMode();
+
+    /**
+     * Level number of the loaded replay
+     */
+    static size_t getLevel();
+
+    /**
+     * Must be called before a level is loaded
+     * Recording: reset the random seed and start a new recording
+     * Playing: restore random seed and player items from the replay
+     */
+    static void beginLevel(size_t level);
+
+    /**
+     * Recording: save the recording to the file
+     * Playing: print replay statistics
+     */
+    static void endLevel();
+
+    /**
+     * Recording: store an action sent to the player during the current frame
+     * @param pressed: true for Player::onActionDown, false for Player::onActionUp
+     */
+    static void recordAction(Action::ID action, bool pressed);
+
+    /**
+     * Recording: store frame time and actions state, must be called once per frame
+     * after events were processed
+     */
+    static void recordFrame(float frametime);
+
+    /**
+     * Playing: restore actions state and frame time of the next frame, and send the
+     * recorded actions to the player
+     * @param frametime: set to the recorded frame time
+     * @return false if replay is over
+     */
+    static bool playFrame(float& frametime, Player& player);
+
+private:
+    struct Frame
+    {
+        float    frametime;
+        uint32_t pressed;     // Input::getPressedState
+        uint32_t event_count; // Actions sent to the player during this frame
+    };
+
+    static Mode                 s_mode;
+    static std::string          s_filename;
+    static uint32_t             s_seed;
+    static uint32_t             s_level;
+    static std::vector<uint8_t> s_items;  // Item level, indexed by Item::Type
+    static std::vector<Frame>   s_frames;
+    static std::vector<uint8_t> s_events; // Action ID, high bit set for onActionDown
+    static uint32_t             s_pending_events; // Actions recorded during the current frame
+    static size_t               s_current_frame;
+    static size_t               s_current_event;
+    static float                s_elapsed;
+    static bool                 s_saved;
+};
+
+#endif // REPLAY_HPP
@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include "ResourcePack.hpp"
+
+#if defined(_WIN32) || defined(__WIN32__)
+    #define SYS_WINDOWS
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#define PACK_MAGIC   "CSRP"
+#define PACK_VERSION 1
+
+namespace {
+
+// Pack file header, as stored in the pack file (little-endian)
+struct Header
+{
+    char     magic[4];
+    uint32_t version;
+    uint32_t count;
+    uint32_t reserved;
+};
+
+}
+
+
+ResourcePack::ResourcePack():
+    m_data(NULL),
+    m_size(0),
+    m_entries(NULL),
+    m_count(0)
+#ifdef SYS_WINDOWS
+    , m_mapping(NULL)
+#endif
+{
+}
+
+
+ResourcePack::~ResourcePack()
+{
+    close();
+}
+
+
+bool ResourcePack::open(const std::string& filename)
+{
+    close();
+
+#ifdef SYS_WINDOWS
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER file_size;
+    GetFileSizeEx(file, &file_size);
+    m_mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (m_mapping == NULL)
+        return false;
+
+    m_data = static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    m_size = static_cast<size_t>(file_size.QuadPart);
+    if (m_data == NULL)
+    {
+        close();
+        return false;
+    }
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd == -1)
+        return false;
+
+    struct stat sb;
+    if (fstat(fd, &sb) == 0 && sb.st_size > 0)
+    {
+        void* data = mmap(NULL, sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED)
+        {
+            m_data = static_cast<const char*>(data);
+            m_size = sb.st_size;
+        }
+    }
+    // The mapping remains valid after closing the file descriptor
+    ::close(fd);
+    if (m_data == NULL)
+        return false;
+#endif
+
+    // Check header and index bounds, so lookups can trust the pack content
+    const Header* header = reinterpret_cast<const Header*>(m_data);
+    if (m_size < sizeof (Header) || std::memcmp(header->magic, PACK_MAGIC, 4) != 0 || header->version != PACK_VERSION
+        || header->count > (m_size - sizeof (Header)) / sizeof (Entry))
+    {
+        std::cerr << "Invalid resource pack: " << filename << std::endl;
+        close();
+        return false;
+    }
+
+    m_entries = reinterpret_cast<const Entry*>(m_data + sizeof (Header));
+    m_count = header->count;
+    for (size_t i = 0; i < m_count; ++i)
+    {
+        if (m_entries[i].offset > m_size || m_entries[i].size > m_size - m_entries[i].offset)
+        {
+            std::cerr << "Invalid resource pack: " << filename << " (entry " << i << " out of bounds)" << std::endl;
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+
+void ResourcePack::close()
+{
+    if (m_data != NULL)
+    {
+#ifdef SYS_WINDOWS
+        UnmapViewOfFile(m_data);
+#else
+        munmap(const_cast<char*>(m_data), m_size);
+#endif
+    }
+#ifdef SYS_WINDOWS
+    if (m_mapping != NULL)
+    {
+        CloseHandle(m_mapping);
+        m_mapping = NULL;
+    }
+#endif
+    m_data = NULL;
+    m_size = 0;
+    m_entries = NULL;
+    m_count = 0;
+}
+
+
+bool ResourcePack::isOpen() const
+{
+    return m_data != NULL;
+}
+
+
+const void* ResourcePack::find(uint32_t key, size_t& size) const
+{
+    const Entry* end = m_entries + m_count;
+    const Entry* entry = std::lower_bound(m_entries, end, key, [](const Entry& e, uint32_t hash) {
+        return e.hash < hash;
+    });
+    if (entry != end && entry->hash == key)
+    {
+        size = entry->size;
+        return m_data + entry->offset;
+    }
+    return NULL;
+}
+
+
+size_t ResourcePack::getFileCount() const
+{
+    return m_count;
+}
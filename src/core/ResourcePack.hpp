@@ -0,0 +1,65 @@
+#ifndef RESOURCEPACK_HPP
+#define RESOURCEPACK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Read-only archive of resource files, built by tools/build_pack.py
+ * The pack file is memory-mapped: file contents are read directly from the mapping,
+ * which remains valid until the pack is closed.
+ */
+class ResourcePack
+{
+public:
+    ResourcePack();
+
+    ~ResourcePack();
+
+    /**
+     * Map a pack file in memory
+     * @return false if file cannot be mapped or isn't a valid pack
+     */
+    bool open(const std::string& filename);
+
+    /**
+     * Unmap the pack file, previously returned pointers become invalid
+     */
+    void close();
+
+    bool isOpen() const;
+
+    /**
+     * Find a file in the pack
+     * @param key: hash of the file path relative to the resources directory (see utils::hash)
+     * @param size: set to the file size, in bytes
+     * @return pointer to the file contents, or NULL if file isn't in the pack
+     */
+    const void* find(uint32_t key, size_t& size) const;
+
+    /**
+     * Number of files in the pack
+     */
+    size_t getFileCount() const;
+
+private:
+    // Index entry, as stored in the pack file (little-endian)
+    struct Entry
+    {
+        uint32_t hash;
+        uint32_t offset;
+        uint32_t size;
+        uint32_t crc;
+    };
+
+    const char*  m_data;
+    size_t       m_size;
+    const Entry* m_entries; // Sorted by hash
+    size_t       m_count;
+#if defined(_WIN32) || defined(__WIN32__)
+    void*        m_mapping; // Windows file mapping handle
+#endif
+};
+
+#endif // RESOURCEPACK_HPP
@@ -1,10 +1,57 @@
+#include <algorithm>
+#include <stdexcept>
+#include <SFML/Graphics/Texture.hpp>
 #include "Resources.hpp"
+#include "StartupReport.hpp"
+#include "utils/FileSystem.hpp"
+#include "utils/TaskGraph.hpp"
 
 
-std::string           Resources::m_path = "./";
-Resources::TextureMap Resources::m_textures;
-Resources::FontMap    Resources::m_fonts;
-Resources::SoundMap   Resources::m_sounds;
+std::string             Resources::m_path = "./";
+ResourcePack            Resources::m_pack;
+Resources::TextureMap   Resources::m_textures;
+Resources::FontMap      Resources::m_fonts;
+Resources::SoundMap     Resources::m_sounds;
+std::atomic<int>        Resources::m_concurrent_scopes(0);
+std::mutex              Resources::m_cache_mutex;
+std::condition_variable Resources::m_cache_loaded;
+std::mutex              Resources::m_context_mutex;
+
+
+namespace {
+
+StartupReport::Category report_category(const sf::Font&)
+{
+    return StartupReport::FONT;
+}
+
+
+StartupReport::Category report_category(const sf::SoundBuffer&)
+{
+    return StartupReport::SOUND;
+}
+
+}
+
+
+Resources::ConcurrentLoading::ConcurrentLoading()
+{
+    ++m_concurrent_scopes;
+}
+
+
+Resources::ConcurrentLoading::~ConcurrentLoading()
+{
+    --m_concurrent_scopes;
+}
+
+
+Resources::ContextLock::ContextLock():
+    m_lock(m_context_mutex, std::defer_lock)
+{
+    if (m_concurrent_scopes > 0)
+        m_lock.lock();
+}
 
 
 void Resources::setSearchPath(const std::string& path)
@@ -22,40 +69,127 @@ const std::string& Resources::getSearchPath()
 }
 
 
-sf::Texture& Resources::getTexture(const std::string& name)
+bool Resources::openPack(const std::string& filename)
 {
-    TextureMap::iterator it = m_textures.find(name);
-    if (it == m_textures.end())
+    return m_pack.open(filename);
+}
+
+
+template <class T>
+size_t Resources::read(T& resource, const char* name, const char* directory)
+{
+    // Pack entries are indexed by their path relative to the search path
+    size_t size = 0;
+    const void* data = m_pack.isOpen() ? m_pack.find(utils::hash(name, utils::hash(directory)), size) : NULL;
+    if (data != NULL)
     {
-        sf::Texture& texture = m_textures[name];
-        texture.loadFromFile(m_path + "/images/" + name);
-        return texture;
+        resource.loadFromMemory(data, size);
+        return size;
     }
-    return it->second;
+    const std::string path = m_path + "/" + directory + name;
+    resource.loadFromFile(path);
+    return StartupReport::isEnabled() ? filesystem::file_size(path) : 0;
+}
+
+
+template <class T>
+void Resources::load(T& resource, const char* name, const char* directory)
+{
+    const float start = StartupReport::getTime();
+    size_t size = read(resource, name, directory);
+    StartupReport::add(report_category(resource), std::string(directory) + name, size, start, StartupReport::getTime());
 }
 
 
-sf::Font& Resources::getFont(const std::string& name)
+template <>
+void Resources::load(sf::Texture& texture, const char* name, const char* directory)
 {
-    FontMap::iterator it = m_fonts.find(name);
-    if (it == m_fonts.end())
+    // Decode the image without holding the context lock, only the upload needs OpenGL
+    const float start = StartupReport::getTime();
+    sf::Image image;
+    size_t size = read(image, name, directory);
+    const float decoded = StartupReport::getTime();
     {
-        sf::Font& font = m_fonts[name];
-        font.loadFromFile(m_path + "/fonts/" + name);
-        return font;
+        ContextLock lock;
+        texture.loadFromImage(image);
     }
-    return it->second;
+    // Upload time includes waiting for the context lock
+    StartupReport::addTexture(std::string(directory) + name, size, start, decoded, StartupReport::getTime());
 }
 
 
-sf::SoundBuffer& Resources::getSoundBuffer(const std::string& name)
+template <class T>
+T& Resources::get(std::unordered_map<uint32_t, Entry<T>>& cache, const Key& key, const char* directory)
 {
-    SoundMap::iterator it = m_sounds.find(name);
-    if (it == m_sounds.end())
+    const bool concurrent = m_concurrent_scopes > 0;
+    std::unique_lock<std::mutex> lock(m_cache_mutex, std::defer_lock);
+    if (concurrent)
+        lock.lock();
+
+    typename std::unordered_map<uint32_t, Entry<T>>::iterator it = cache.find(key.hash);
+    if (it == cache.end())
+    {
+        // References to unordered_map elements remain valid after rehashing
+        Entry<T>& entry = cache[key.hash];
+        entry.name = key.name;
+        entry.loaded = false;
+
+        // Other threads can load other resources meanwhile
+        if (concurrent)
+            lock.unlock();
+
+        load(entry.resource, key.name, directory);
+
+        if (concurrent)
+            lock.lock();
+        entry.loaded = true;
+        if (concurrent)
+            m_cache_loaded.notify_all();
+        return entry.resource;
+    }
+    // Two filenames with the same hash would silently share a resource
+    if (it->second.name != key.name)
+        throw std::runtime_error("Resource hash collision between '" + it->second.name + "' and '" + key.name + "'");
+
+    // Resource may be still loading in another thread
+    if (concurrent)
     {
-        sf::SoundBuffer& sound = m_sounds[name];
-        sound.loadFromFile(m_path + "/sounds/" + name);
-        return sound;
+        Entry<T>& entry = it->second;
+        m_cache_loaded.wait(lock, [&entry]() { return entry.loaded; });
     }
-    return it->second;
+    return it->second.resource;
+}
+
+
+void Resources::loadTextures(const std::vector<std::string>& names)
+{
+    // One task per texture, animations often share the same image
+    std::vector<std::string> unique_names(names);
+    std::sort(unique_names.begin(), unique_names.end());
+    unique_names.erase(std::unique(unique_names.begin(), unique_names.end()), unique_names.end());
+
+    ConcurrentLoading scope;
+    TaskGraph tasks;
+    for (const std::string& name: unique_names)
+        tasks.add([&name]() { getTexture(name); });
+
+    tasks.run();
+}
+
+
+sf::Texture& Resources::getTexture(const Key& key)
+{
+    return get(m_textures, key, "images/");
+}
+
+
+sf::Font& Resources::getFont(const Key& key)
+{
+    return get(m_fonts, key, "fonts/");
+}
+
+
+sf::SoundBuffer& Resources::getSoundBuffer(const Key& key)
+{
+    return get(m_sounds, key, "sounds/");
 }
@@ -1,19 +1,73 @@
 #ifndef RESOURCES_HPP
 #define RESOURCES_HPP
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <string>
-#include <map>
+#include <unordered_map>
+#include <vector>
 
 #include <SFML/Graphics/Image.hpp>
 #include <SFML/Graphics/Font.hpp>
 #include <SFML/Audio/SoundBuffer.hpp>
 
+#include "ResourcePack.hpp"
+#include "utils/StringUtils.hpp"
+
 /**
  * Static class for loading and storing resources
+ * Resources are indexed by the hash of their filename (see utils::hash), lookups
+ * never allocate memory.
+ * Resources can be requested from several threads inside a ConcurrentLoading scope:
+ * files are decoded in parallel, and only OpenGL calls are serialised.
  */
 class Resources
 {
 public:
+    /**
+     * Resource filename with its precomputed hash
+     * Declare keys as constexpr to hash filenames at compile time, for lookups in hot paths:
+     *   static constexpr Resources::Key BOOM("boom.ogg");
+     */
+    struct Key
+    {
+        constexpr Key(const char* filename):
+            name(filename),
+            hash(utils::hash(filename))
+        {
+        }
+
+        const char* name;
+        uint32_t    hash;
+    };
+
+    /**
+     * Scope during which resources can be requested from several threads
+     * Caches are locked and OpenGL calls are serialised while a scope is alive, lookups
+     * don't lock anything otherwise.
+     */
+    class ConcurrentLoading
+    {
+    public:
+        ConcurrentLoading();
+        ~ConcurrentLoading();
+    };
+
+    /**
+     * Lock held while calling OpenGL, inside a ConcurrentLoading scope
+     * Must be held by code using OpenGL while resources are being loaded (such as
+     * reading a texture back).
+     */
+    class ContextLock
+    {
+    public:
+        ContextLock();
+
+    private:
+        std::unique_lock<std::mutex> m_lock;
+    };
+
     /**
      * Set path where resources are located
      */
@@ -24,35 +78,118 @@ public:
      */
     static const std::string& getSearchPath();
 
+    /**
+     * Load images, sounds and fonts from a pack file (see tools/build_pack.py)
+     * Resources missing from the pack are still loaded from the search path.
+     * @return true if pack was opened
+     */
+    static bool openPack(const std::string& filename);
+
     /**
      * Get a texture from the 'images' directory
      * @param name: texture filename
      */
-    static sf::Texture& getTexture(const std::string& name);
+    static sf::Texture& getTexture(const Key& key);
+
+    static sf::Texture& getTexture(const char* name)
+    {
+        return getTexture(Key(name));
+    }
+
+    static sf::Texture& getTexture(const std::string& name)
+    {
+        return getTexture(name.c_str());
+    }
+
+    /**
+     * Load textures concurrently, images are decoded on a pool of threads
+     * @param names: texture filenames
+     */
+    static void loadTextures(const std::vector<std::string>& names);
 
     /**
      * Get a font from the 'fonts' directory
      * @param name: font filename
      */
-    static sf::Font& getFont(const std::string& name);
+    static sf::Font& getFont(const Key& key);
+
+    static sf::Font& getFont(const char* name)
+    {
+        return getFont(Key(name));
+    }
+
+    static sf::Font& getFont(const std::string& name)
+    {
+        return getFont(name.c_str());
+    }
 
     /**
      * Get a sound buffer from the 'sounds' directory
      * @param name: sound buffer filename
      */
-    static sf::SoundBuffer& getSoundBuffer(const std::string& name);
+    static sf::SoundBuffer& getSoundBuffer(const Key& key);
+
+    static sf::SoundBuffer& getSoundBuffer(const char* name)
+    {
+        return getSoundBuffer(Key(name));
+    }
+
+    static sf::SoundBuffer& getSoundBuffer(const std::string& name)
+    {
+        return getSoundBuffer(name.c_str());
+    }
 
 private:
+    /**
+     * Cached resource, with its interned filename
+     */
+    template <class T>
+    struct Entry
+    {
+        T           resource;
+        std::string name;
+        bool        loaded; // False while another thread is loading the resource
+    };
+
+    /**
+     * Get a resource from the cache, load it on first access
+     * @param directory: resource location, relative to the search path (with trailing slash)
+     * @throw std::runtime_error if another resource with the same hash is cached
+     */
+    template <class T>
+    static T& get(std::unordered_map<uint32_t, Entry<T>>& cache, const Key& key, const char* directory);
+
+    /**
+     * Read a resource from the pack, or from the search path
+     * @return bytes read (0 for files if the startup report isn't enabled)
+     */
+    template <class T>
+    static size_t read(T& resource, const char* name, const char* directory);
+
+    /**
+     * Load a resource, and add it to the startup report
+     */
+    template <class T>
+    static void load(T& resource, const char* name, const char* directory);
+
     static std::string m_path;
 
-    typedef std::map<std::string, sf::Texture> TextureMap;
+    // Must be declared before caches: fonts keep reading the pack memory
+    static ResourcePack m_pack;
+
+    typedef std::unordered_map<uint32_t, Entry<sf::Texture>> TextureMap;
     static TextureMap m_textures;
 
-    typedef std::map<std::string, sf::Font> FontMap;
+    typedef std::unordered_map<uint32_t, Entry<sf::Font>> FontMap;
     static FontMap m_fonts;
 
-    typedef std::map<std::string, sf::SoundBuffer> SoundMap;
+    typedef std::unordered_map<uint32_t, Entry<sf::SoundBuffer>> SoundMap;
     static SoundMap m_sounds;
+
+    static std::atomic<int>        m_concurrent_scopes; // Number of alive ConcurrentLoading scopes
+    static std::mutex              m_cache_mutex;
+    static std::condition_variable m_cache_loaded;      // Notified when a resource is loaded
+    static std::mutex              m_context_mutex;
 };
 
 #endif // RESOURCES_HPP
@@ -1,15 +1,42 @@
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
 #include "SoundSystem.hpp"
 #include "Resources.hpp"
-
-
-sf::Sound     SoundSystem::m_sounds[MAX_SOUNDS];
-int           SoundSystem::m_last_sound_played = 0;
+#include "Constants.hpp"
+#include "utils/FileSystem.hpp"
+#include "vendor/tinyxml/tinyxml2.h"
+
+#define MUSIC_CACHE_DIRECTORY "music"
+
+
+// Maximum time the audio thread sleeps before checking the queue again
+#define AUDIO_THREAD_WAKEUP 5
+
+SoundSystem::Voice      SoundSystem::m_voices[MAX_SOUNDS];
+size_t                  SoundSystem::m_sequence = 0;
+SoundSystem::VoiceStats SoundSystem::m_next_stats = {0, 0, 0, 0};
+SoundSystem::ProfileMap SoundSystem::m_profiles;
+SPSCQueue<SoundSystem::SoundCommand, SoundSystem::QUEUE_SIZE> SoundSystem::m_commands;
+std::atomic<int>        SoundSystem::m_queue_overflows(0);
+std::atomic<bool>       SoundSystem::m_audio_running(false);
+std::thread             SoundSystem::m_audio_thread;
+std::mutex              SoundSystem::m_wakeup_mutex;
+std::condition_variable SoundSystem::m_wakeup;
+std::mutex              SoundSystem::m_stats_mutex;
+SoundSystem::VoiceStats SoundSystem::m_stats = {0, 0, 0, 0};
+size_t                  SoundSystem::m_frame = 0;
 ModMusic      SoundSystem::m_music;
 int           SoundSystem::m_music_volume = 100;
+int           SoundSystem::m_music_buffer_length = 2000;
+bool          SoundSystem::m_music_prerendering = false;
 int           SoundSystem::m_sound_volume = 100;
 bool          SoundSystem::m_enable_music = true;
 bool          SoundSystem::m_enable_sound = true;
 
+// Must be defined last: the audio thread is stopped before any other member is destroyed
+SoundSystem::Init SoundSystem::s_init;
+
 template <class T>
 static inline void clamp(T& value, T min, T max)
 {
@@ -20,9 +47,45 @@ static inline void clamp(T& value, T min, T max)
 }
 
 
+void SoundSystem::loadSoundProfiles(const std::string& filename)
+{
+    // Open XML document
+    tinyxml2::XMLDocument doc;
+    if (doc.LoadFile(filename.c_str()) != 0)
+    {
+        std::string error = "Cannot load sound profiles from " + filename + ": " + doc.GetErrorStr1();
+        throw std::runtime_error(error);
+    }
+
+    tinyxml2::XMLElement* elem = doc.RootElement()->FirstChildElement("sound");
+    while (elem != NULL)
+    {
+        const char* name = elem->Attribute("name");
+        if (name == NULL)
+            throw std::runtime_error("XML error: sound.name is missing");
+
+        SoundProfile& profile = m_profiles[&Resources::getSoundBuffer(name)];
+        elem->QueryIntAttribute("priority", &profile.priority);
+        elem->QueryIntAttribute("max", &profile.max_instances);
+        clamp(profile.max_instances, 1, MAX_SOUNDS);
+
+        elem = elem->NextSiblingElement("sound");
+    }
+}
+
+
+void SoundSystem::update()
+{
+    ++m_frame;
+}
+
+
 bool SoundSystem::openMusicFromFile(const std::string& path)
 {
     stopMusic();
+    if (m_music.getUnderrunCount() > 0)
+        std::cerr << "[SoundSystem] music buffer underruns: " << m_music.getUnderrunCount() << std::endl;
+
     if (m_music.openFromFile(path))
     {
         m_music.setLoop(true);
@@ -54,30 +117,165 @@ void SoundSystem::pauseMusic()
 }
 
 
-void SoundSystem::playSound(const std::string& name, float pitch)
+void SoundSystem::playSound(const sf::SoundBuffer& soundbuffer, float pitch)
 {
-    playSound(Resources::getSoundBuffer(name), pitch);
+    if (!m_enable_sound)
+        return;
+
+    SoundCommand command = {SoundCommand::PLAY, &soundbuffer, pitch, m_frame};
+    if (!pushCommand(command))
+    {
+        // Never block the game thread for a sound effect
+        ++m_queue_overflows;
+    }
 }
 
 
-void SoundSystem::playSound(const sf::SoundBuffer& soundbuffer, float pitch)
+bool SoundSystem::pushCommand(const SoundCommand& command)
+{
+    if (!m_audio_thread.joinable())
+    {
+        m_audio_running = true;
+        m_audio_thread = std::thread(&SoundSystem::processCommands);
+    }
+    if (m_commands.push(command))
+    {
+        m_wakeup.notify_one();
+        return true;
+    }
+    return false;
+}
+
+
+void SoundSystem::processCommands()
+{
+    sf::Clock stats_clock;
+    while (m_audio_running)
+    {
+        SoundCommand command;
+        while (m_commands.pop(command))
+        {
+            switch (command.type)
+            {
+                case SoundCommand::PLAY:
+                    processPlay(command);
+                    break;
+                case SoundCommand::SET_VOLUME:
+                    for (int i = 0; i < MAX_SOUNDS; ++i)
+                        m_voices[i].sound.setVolume(command.value);
+                    break;
+                case SoundCommand::STOP:
+                    for (int i = 0; i < MAX_SOUNDS; ++i)
+                        m_voices[i].sound.stop();
+                    break;
+            }
+        }
+
+        // Publish statistics every second
+        if (stats_clock.getElapsedTime() >= sf::seconds(1.f))
+        {
+            m_next_stats.dropped += m_queue_overflows.exchange(0);
+            std::lock_guard<std::mutex> lock(m_stats_mutex);
+            m_stats = m_next_stats;
+            m_next_stats = {0, 0, 0, 0};
+            stats_clock.restart();
+        }
+
+        // Producer doesn't take the lock when notifying, so a wakeup may be missed:
+        // the timeout bounds the latency in that case
+        std::unique_lock<std::mutex> lock(m_wakeup_mutex);
+        m_wakeup.wait_for(lock, std::chrono::milliseconds(AUDIO_THREAD_WAKEUP));
+    }
+
+    for (int i = 0; i < MAX_SOUNDS; ++i)
+        m_voices[i].sound.stop();
+}
+
+
+void SoundSystem::stopAudioThread()
+{
+    m_audio_running = false;
+    if (m_audio_thread.joinable())
+    {
+        m_wakeup.notify_one();
+        m_audio_thread.join();
+    }
+}
+
+
+void SoundSystem::processPlay(const SoundCommand& command)
 {
-    if (m_enable_sound)
+    const sf::SoundBuffer* soundbuffer = command.buffer;
+    ProfileMap::const_iterator it = m_profiles.find(soundbuffer);
+    const SoundProfile profile = it != m_profiles.end() ? it->second : SoundProfile();
+
+    Voice* free_voice = NULL; // First available voice
+    Voice* oldest = NULL;     // Oldest voice playing the same sound
+    Voice* victim = NULL;     // Oldest voice with the lowest priority
+    int instances = 0;
+    for (int i = 0; i < MAX_SOUNDS; ++i)
     {
-        if (m_last_sound_played == MAX_SOUNDS)
+        Voice& voice = m_voices[i];
+        if (voice.sound.getStatus() != sf::Sound::Playing)
         {
-            m_last_sound_played = 0;
+            if (free_voice == NULL)
+                free_voice = &voice;
+            continue;
         }
-        sf::Sound& sound = m_sounds[m_last_sound_played];
-        if (sound.getStatus() == sf::Sound::Playing)
+
+        if (voice.sound.getBuffer() == soundbuffer)
         {
-            sound.stop();
+            if (voice.frame == command.frame)
+            {
+                ++m_next_stats.deduplicated;
+                return;
+            }
+            ++instances;
+            if (oldest == NULL || voice.sequence < oldest->sequence)
+                oldest = &voice;
         }
-        sound.setBuffer(soundbuffer);
-        sound.setPitch(pitch);
-        sound.play();
-        ++m_last_sound_played;
+
+        if (victim == NULL || voice.priority < victim->priority
+            || (voice.priority == victim->priority && voice.sequence < victim->sequence))
+            victim = &voice;
+    }
+
+    if (instances >= profile.max_instances)
+    {
+        // Too many instances of this sound, restart the oldest one
+        ++m_next_stats.stolen;
+        startVoice(*oldest, command, profile.priority);
+    }
+    else if (free_voice != NULL)
+    {
+        startVoice(*free_voice, command, profile.priority);
+    }
+    else if (victim->priority <= profile.priority)
+    {
+        ++m_next_stats.stolen;
+        startVoice(*victim, command, profile.priority);
+    }
+    else
+    {
+        // All voices are busy with more important sounds
+        ++m_next_stats.dropped;
+    }
+}
+
+
+void SoundSystem::startVoice(Voice& voice, const SoundCommand& command, int priority)
+{
+    if (voice.sound.getStatus() == sf::Sound::Playing)
+    {
+        voice.sound.stop();
     }
+    voice.sound.setBuffer(*command.buffer);
+    voice.sound.setPitch(command.value);
+    voice.sound.play();
+    voice.priority = priority;
+    voice.sequence = m_sequence++;
+    voice.frame = command.frame;
+    ++m_next_stats.played;
 }
 
 
@@ -99,10 +297,9 @@ void SoundSystem::setSoundVolume(int volume)
 {
     clamp(volume, 0, 100);
     m_sound_volume = volume;
-    for (int i = 0; i < MAX_SOUNDS; ++i)
-    {
-        m_sounds[i].setVolume(volume);
-    }
+    SoundCommand command = {SoundCommand::SET_VOLUME, NULL, static_cast<float>(volume), m_frame};
+    while (!pushCommand(command))
+        std::this_thread::yield();
 }
 
 
@@ -138,14 +335,78 @@ bool SoundSystem::isSoundEnabled()
 }
 
 
-void SoundSystem::stopAll()
+void SoundSystem::enableMusicPrerendering(bool enabled)
 {
-    for (int i = 0; i < MAX_SOUNDS; ++i)
+    std::string cache_dir;
+    if (enabled)
     {
-        if (m_sounds[i].getStatus() == sf::Sound::Playing)
+        cache_dir = filesystem::init_settings_directory(COSMOSCROLL_DIRECTORY) + "/" + MUSIC_CACHE_DIRECTORY;
+        if (!filesystem::is_directory(cache_dir) && !filesystem::create_directory(cache_dir))
         {
-            m_sounds[i].stop();
+            enabled = false;
+            cache_dir.clear();
         }
     }
+    m_music_prerendering = enabled;
+    ModMusic::setCacheDirectory(cache_dir);
+}
+
+
+bool SoundSystem::isMusicPrerenderingEnabled()
+{
+    return m_music_prerendering;
+}
+
+
+void SoundSystem::setMusicBufferLength(int milliseconds)
+{
+    clamp(milliseconds, 100, 10000);
+    m_music_buffer_length = milliseconds;
+    ModMusic::setBufferDuration(sf::milliseconds(milliseconds));
+}
+
+
+int SoundSystem::getMusicBufferLength()
+{
+    return m_music_buffer_length;
+}
+
+
+size_t SoundSystem::getMusicUnderruns()
+{
+    return m_music.getUnderrunCount();
+}
+
+
+SoundSystem::VoiceStats SoundSystem::getVoiceStats()
+{
+    std::lock_guard<std::mutex> lock(m_stats_mutex);
+    return m_stats;
+}
+
+
+void SoundSystem::stopAll()
+{
+    if (m_audio_thread.joinable())
+    {
+        SoundCommand command = {SoundCommand::STOP, NULL, 0.f, m_frame};
+        while (!pushCommand(command))
+            std::this_thread::yield();
+    }
     stopMusic();
 }
+
+// SoundSystem::Init -----------------------------------------------------------
+
+SoundSystem::Init::~Init()
+{
+    stopAudioThread();
+}
+
+// SoundSystem::SoundProfile ---------------------------------------------------
+
+SoundSystem::SoundProfile::SoundProfile():
+    priority(1),
+    max_instances(MAX_SOUNDS)
+{
+}
@@ -1,15 +1,47 @@
 #ifndef SOUNDSYSTEM_HPP
 #define SOUNDSYSTEM_HPP
 
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
 #include <SFML/Audio.hpp>
+#include "Resources.hpp"
 #include "utils/ModMusic.hpp"
+#include "utils/SPSCQueue.hpp"
 
 /**
  * Static class for playing sound effects and music
+ * Sound effects requests are queued and played by a dedicated audio thread, so
+ * gameplay code never waits on the audio device.
  */
 class SoundSystem
 {
 public:
+    /**
+     * Sound effects statistics, over the last second
+     */
+    struct VoiceStats
+    {
+        int played;       // Sounds started
+        int stolen;       // Playing sounds interrupted to free a voice
+        int dropped;      // Sounds not played because no voice could be freed, or queue was full
+        int deduplicated; // Sounds ignored because already started in the same frame
+    };
+
+    /**
+     * Load sound effects priorities and instance limits
+     * Must be called before playing any sound effect
+     * @param filename: path to XML document
+     */
+    static void loadSoundProfiles(const std::string& filename);
+
+    /**
+     * Must be called once per frame
+     */
+    static void update();
+
     /**
      * Control music
      */
@@ -19,10 +51,21 @@ public:
     static void pauseMusic();
 
     /**
-     * Play a sound effect
+     * Play a sound effect (asynchronously, on the audio thread)
+     * If all voices are busy, the oldest voice with the lowest priority is interrupted.
+     * A sound already started in the current frame is not played twice.
      * @param name: sound buffer filename in the Resources class loader
      */
-    static void playSound(const std::string& name, float pitch = 1.f);
+    static void playSound(const char* name, float pitch = 1.f)
+    {
+        playSound(Resources::getSoundBuffer(name), pitch);
+    }
+
+    static void playSound(const Resources::Key& name, float pitch = 1.f)
+    {
+        playSound(Resources::getSoundBuffer(name), pitch);
+    }
+
     static void playSound(const sf::SoundBuffer& soundbuffer, float pitch = 1.f);
 
     /**
@@ -49,6 +92,29 @@ public:
     static void enableSound(bool enabled);
     static bool isSoundEnabled();
 
+    /**
+     * Pre-render music modules to PCM files in the settings directory, and stream
+     * these files instead of rendering modules when playing music
+     */
+    static void enableMusicPrerendering(bool enabled);
+    static bool isMusicPrerenderingEnabled();
+
+    /**
+     * Duration of music rendered ahead of playback, in milliseconds
+     */
+    static void setMusicBufferLength(int milliseconds);
+    static int getMusicBufferLength();
+
+    /**
+     * Number of music buffer underruns since the current music was opened
+     */
+    static size_t getMusicUnderruns();
+
+    /**
+     * Get sound effects statistics for the last second
+     */
+    static VoiceStats getVoiceStats();
+
     /**
      * Stop music and sound effects
      */
@@ -56,11 +122,85 @@ public:
 
 private:
     static const int MAX_SOUNDS = 20;
+    static const int QUEUE_SIZE = 256;
+
+    static struct Init
+    {
+        ~Init(); // static dtor
+    } s_init;
+
+    /**
+     * Request sent from the game thread to the audio thread
+     */
+    struct SoundCommand
+    {
+        enum Type
+        {
+            PLAY,       // Play buffer at given pitch
+            SET_VOLUME, // Set volume of all voices
+            STOP        // Stop all voices
+        };
+
+        Type                   type;
+        const sf::SoundBuffer* buffer;
+        float                  value; // Pitch (PLAY) or volume (SET_VOLUME)
+        size_t                 frame; // Game frame number when the command was sent
+    };
+
+    struct Voice
+    {
+        sf::Sound sound;
+        int       priority;
+        size_t    sequence; // Incremented each time a sound is played, lowest is oldest
+        size_t    frame;    // Frame number when the sound was played
+    };
+
+    struct SoundProfile
+    {
+        SoundProfile();
+
+        int priority;      // Higher priority sounds can interrupt lower priority sounds
+        int max_instances; // Instances of the same sound playing simultaneously
+    };
+
+    /**
+     * Send a command to the audio thread, started on first use
+     * @return false if the queue is full
+     */
+    static bool pushCommand(const SoundCommand& command);
+
+    /**
+     * Audio thread: execute queued commands until the thread is stopped
+     */
+    static void processCommands();
+    static void stopAudioThread();
+
+    static void processPlay(const SoundCommand& command);
+    static void startVoice(Voice& voice, const SoundCommand& command, int priority);
+
+    typedef std::map<const sf::SoundBuffer*, SoundProfile> ProfileMap;
+
+    // Owned by the audio thread
+    static Voice       m_voices[MAX_SOUNDS];
+    static size_t      m_sequence;
+    static VoiceStats  m_next_stats; // Statistics for the current second
+
+    // Shared between the game thread and the audio thread
+    static ProfileMap  m_profiles;  // Read-only once loaded
+    static SPSCQueue<SoundCommand, QUEUE_SIZE> m_commands;
+    static std::atomic<int>        m_queue_overflows;
+    static std::atomic<bool>       m_audio_running;
+    static std::thread             m_audio_thread;
+    static std::mutex              m_wakeup_mutex;
+    static std::condition_variable m_wakeup;
+    static std::mutex  m_stats_mutex;
+    static VoiceStats  m_stats;     // Statistics for the last second, guarded by m_stats_mutex
 
-    static sf::Sound   m_sounds[MAX_SOUNDS];
-    static int         m_last_sound_played;
+    static size_t      m_frame;
     static ModMusic    m_music;
     static int         m_music_volume;
+    static int         m_music_buffer_length;
+    static bool        m_music_prerendering;
     static int         m_sound_volume;
     static bool        m_enable_music;
     static bool        m_enable_sound;
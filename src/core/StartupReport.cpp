@@ -0,0 +1,128 @@
+#include <fstream>
+#include <iostream>
+#include "StartupReport.hpp"
+
+bool                             StartupReport::s_enabled = false;
+sf::Clock                        StartupReport::s_clock;
+std::mutex                       StartupReport::s_mutex;
+std::vector<StartupReport::Step> StartupReport::s_steps[_CATEGORY_COUNT];
+
+namespace {
+
+const char* CATEGORY_NAMES[StartupReport::_CATEGORY_COUNT] = {
+    "files", "textures", "fonts", "sounds", "window"
+};
+
+/**
+ * Write a string as a JSON string, paths may contain backslashes
+ */
+void write_string(std::ostream& out, const std::string& value)
+{
+    out << '"';
+    for (char c: value)
+    {
+        if (c == '"' || c == '\\')
+            out << '\\';
+        out << c;
+    }
+    out << '"';
+}
+
+}
+
+
+void StartupReport::setEnabled(bool enabled)
+{
+    s_enabled = enabled;
+}
+
+
+bool StartupReport::isEnabled()
+{
+    return s_enabled;
+}
+
+
+float StartupReport::getTime()
+{
+    return s_clock.getElapsedTime().asSeconds();
+}
+
+
+void StartupReport::add(Category category, const std::string& name, size_t bytes, float start, float end)
+{
+    record(category, name, bytes, start, end, end);
+}
+
+
+void StartupReport::addTexture(const std::string& name, size_t bytes, float start, float decoded, float end)
+{
+    record(TEXTURE, name, bytes, start, decoded, end);
+}
+
+
+void StartupReport::record(Category category, const std::string& name, size_t bytes, float start, float decoded, float end)
+{
+    if (!s_enabled)
+        return;
+
+    Step step;
+    step.name = name;
+    step.bytes = bytes;
+    step.start = start;
+    step.decoded = decoded;
+    step.end = end;
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_steps[category].push_back(step);
+}
+
+
+bool StartupReport::write(const std::string& filename)
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    size_t total_bytes = 0;
+    for (int i = 0; i < _CATEGORY_COUNT; ++i)
+        for (const Step& step: s_steps[i])
+            total_bytes += step.bytes;
+
+    // Times are in milliseconds
+    std::ofstream out(filename.c_str());
+    out << "{\n"
+        << "\"total_ms\": " << getTime() * 1000 << ",\n"
+        << "\"bytes_read\": " << total_bytes << ",\n";
+    for (int i = 0; i < _CATEGORY_COUNT; ++i)
+    {
+        float total = 0.f;
+        for (const Step& step: s_steps[i])
+            total += step.end - step.start;
+
+        out << "\"" << CATEGORY_NAMES[i] << "\": {\n"
+            << "    \"count\": " << s_steps[i].size() << ",\n"
+            << "    \"total_ms\": " << total * 1000 << ",\n"
+            << "    \"steps\": [";
+        for (size_t j = 0; j < s_steps[i].size(); ++j)
+        {
+            const Step& step = s_steps[i][j];
+            out << (j ? ",\n" : "\n") << "        {\"name\": ";
+            write_string(out, step.name);
+            out << ", \"bytes\": " << step.bytes
+                << ", \"start_ms\": " << step.start * 1000
+                << ", \"ms\": " << (step.end - step.start) * 1000;
+            if (i == TEXTURE)
+                out << ", \"decode_ms\": " << (step.decoded - step.start) * 1000
+                    << ", \"upload_ms\": " << (step.end - step.decoded) * 1000;
+            out << "}";
+        }
+        out << (s_steps[i].empty() ? "]\n" : "\n    ]\n")
+            << (i + 1 < _CATEGORY_COUNT ? "},\n" : "}\n");
+    }
+    out << "}\n";
+    if (!out)
+    {
+        std::cerr << "[StartupReport] cannot write " << filename << std::endl;
+        return false;
+    }
+    std::cout << "* startup report written to " << filename << std::endl;
+    return true;
+}
@@ -0,0 +1,75 @@
+#ifndef STARTUPREPORT_HPP
+#define STARTUPREPORT_HPP
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include <SFML/System/Clock.hpp>
+
+/**
+ * Static class recording where startup time goes: XML and configuration files,
+ * textures (decoding and upload), fonts, sounds and window creation, written to
+ * a JSON report
+ * Steps can be recorded from several threads (see Resources::ConcurrentLoading).
+ */
+class StartupReport
+{
+public:
+    enum Category
+    {
+        DATA_FILE, // XML or configuration file, time includes the resources it loads
+        TEXTURE,
+        FONT,
+        SOUND,
+        WINDOW,
+        _CATEGORY_COUNT
+    };
+
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    /**
+     * Time elapsed since program start, in seconds
+     */
+    static float getTime();
+
+    /**
+     * Record a startup step (ignored if the report isn't enabled)
+     * @param name: file or resource name
+     * @param bytes: bytes read from disk or from the resource pack
+     * @param start: start time (see getTime)
+     * @param end: end time
+     */
+    static void add(Category category, const std::string& name, size_t bytes, float start, float end);
+
+    /**
+     * Record a texture, decoded then uploaded (ignored if the report isn't enabled)
+     * @param decoded: time when the image was decoded, and the upload started
+     */
+    static void addTexture(const std::string& name, size_t bytes, float start, float decoded, float end);
+
+    /**
+     * Write the recorded steps to a JSON report
+     * @return true if report was written
+     */
+    static bool write(const std::string& filename);
+
+private:
+    static void record(Category category, const std::string& name, size_t bytes, float start, float decoded, float end);
+
+    struct Step
+    {
+        std::string name;
+        size_t      bytes;
+        float       start;
+        float       end;
+        float       decoded; // Textures only
+    };
+
+    static bool              s_enabled;
+    static sf::Clock         s_clock; // Started at program start
+    static std::mutex        s_mutex;
+    static std::vector<Step> s_steps[_CATEGORY_COUNT];
+};
+
+#endif // STARTUPREPORT_HPP
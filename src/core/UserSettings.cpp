@@ -102,6 +102,8 @@ void UserSettings::loadFromConfig(IniParser& config)
     SoundSystem::setMusicVolume(config.get("music_volume", 100));
     SoundSystem::enableSound(config.get("enable_sound", true));
     SoundSystem::setSoundVolume(config.get("sound_volume", 100));
+    SoundSystem::enableMusicPrerendering(config.get("prerender_music", false));
+    SoundSystem::setMusicBufferLength(config.get("music_buffer", SoundSystem::getMusicBufferLength()));
 }
 
 
@@ -141,4 +143,6 @@ void UserSettings::saveToConfig(IniParser& config)
     config.set("music_volume", SoundSystem::getMusicVolume());
     config.set("enable_sound", SoundSystem::isSoundEnabled());
     config.set("sound_volume", SoundSystem::getSoundVolume());
+    config.set("prerender_music", SoundSystem::isMusicPrerenderingEnabled());
+    config.set("music_buffer", SoundSystem::getMusicBufferLength());
 }
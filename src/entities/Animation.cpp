@@ -3,7 +3,9 @@
 
 Animation::Animation():
     m_texture(NULL),
-    m_delay(1.f)
+    m_delay(1.f),
+    m_timer(0.f),
+    m_current(0)
 {
 }
 
@@ -34,17 +36,18 @@ const sf::Texture& Animation::getTexture() const
 
 float Animation::getDuration() const
 {
-    return m_frames.size() * m_delay;
+    return getFrameCount() * m_delay;
 }
 
 
 void Animation::addFrame(const sf::IntRect& subrect)
 {
+    m_frames.insert(m_frames.begin() + getFrameCount(), subrect);
     m_frames.push_back(subrect);
 }
 
 
-const sf::IntRect& Animation::getFrame(int index) const
+const sf::IntRect& Animation::getFrame(size_t index) const
 {
     return m_frames[index];
 }
@@ -52,6 +55,34 @@ const sf::IntRect& Animation::getFrame(int index) const
 
 size_t Animation::getFrameCount() const
 {
-    return m_frames.size();
+    return m_frames.size() / 2;
+}
+
+
+void Animation::update(float frametime)
+{
+    if (m_delay <= 0 || m_frames.empty())
+        return;
+
+    m_timer += frametime;
+    while (m_timer >= m_delay)
+    {
+        m_timer -= m_delay;
+        if (++m_current == getFrameCount())
+            m_current = 0;
+    }
+}
+
+
+void Animation::reset()
+{
+    m_timer = 0.f;
+    m_current = 0;
+}
+
+
+size_t Animation::getCurrentFrame() const
+{
+    return m_current;
 }
 
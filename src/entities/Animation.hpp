@@ -4,7 +4,12 @@
 #include <vector>
 #include <SFML/Graphics.hpp>
 
-
+/**
+ * Sequence of frames in a texture, played in a loop
+ * All the instances of an animation share the same clock, advanced once per frame
+ * (see update), instances display the current frame shifted by their own phase
+ * (see Animator).
+ */
 class Animation
 {
 public:
@@ -36,20 +41,38 @@ public:
 
     /**
      * Get a frame in the animation
-     * @param index: frame's index
+     * @param index: frame's index, indices up to twice the frame count wrap around
      * @return texture subrect
      */
-    const sf::IntRect& getFrame(int index) const;
+    const sf::IntRect& getFrame(size_t index) const;
 
     /**
      * Get number of frames in the animation
      */
     size_t getFrameCount() const;
 
+    /**
+     * Advance the clock shared by all the instances of the animation
+     */
+    void update(float frametime);
+
+    /**
+     * Rewind the shared clock to the first frame
+     */
+    void reset();
+
+    /**
+     * Index of the frame displayed by the shared clock
+     */
+    size_t getCurrentFrame() const;
+
 private:
+    // Frames are stored twice: frame (current + phase) is looked up without a modulo
     std::vector<sf::IntRect> m_frames;
     const sf::Texture*       m_texture;
     float                    m_delay;
+    float                    m_timer;   // Time elapsed since the current frame is displayed
+    size_t                   m_current; // Current frame index
 };
 
 #endif // ANIMATION_HPP
@@ -0,0 +1,52 @@
+#include "AnimationController.hpp"
+
+
+AnimationController::AnimationController():
+    m_machine(NULL),
+    m_state(-1),
+    m_timer(0.f)
+{
+}
+
+
+void AnimationController::setMachine(sf::Sprite& sprite, const AnimationMachine& machine)
+{
+    m_machine = &machine;
+    m_state = -1;
+    enterState(sprite, 0);
+}
+
+
+void AnimationController::trigger(sf::Sprite& sprite, uint32_t event)
+{
+    int state = m_machine->getTransition(m_state, event);
+    if (state != -1)
+        enterState(sprite, state);
+}
+
+
+void AnimationController::update(sf::Sprite& sprite, float frametime)
+{
+    if (m_timer > 0)
+    {
+        m_timer -= frametime;
+        if (m_timer <= 0)
+            enterState(sprite, m_machine->getNextState(m_state));
+    }
+    m_animator.updateSubRect(sprite);
+}
+
+
+void AnimationController::enterState(sf::Sprite& sprite, int state)
+{
+    if (state == m_state)
+        return;
+
+    m_state = state;
+    m_timer = m_machine->getDuration(state);
+
+    // States may share the same animation
+    const Animation& animation = m_machine->getAnimation(state);
+    if (&animation != m_animator.getAnimation())
+        m_animator.setAnimation(sprite, animation);
+}
@@ -0,0 +1,45 @@
+#ifndef ANIMATIONCONTROLLER_HPP
+#define ANIMATIONCONTROLLER_HPP
+
+#include <cstdint>
+#include <SFML/Graphics.hpp>
+
+#include "AnimationMachine.hpp"
+#include "Animator.hpp"
+
+/**
+ * Instance of an animation state machine, driving the animation of a sprite
+ * Events leading to the current state are ignored, and the sprite is only updated
+ * when the animation changes.
+ */
+class AnimationController
+{
+public:
+    AnimationController();
+
+    /**
+     * Set the state machine, and enter its initial state
+     */
+    void setMachine(sf::Sprite& sprite, const AnimationMachine& machine);
+
+    /**
+     * Notify an event, ignored if the current state has no transition for it
+     * @param event: event name hash (see utils::hash)
+     */
+    void trigger(sf::Sprite& sprite, uint32_t event);
+
+    /**
+     * Follow timed transitions, and update texture subrect
+     */
+    void update(sf::Sprite& sprite, float frametime);
+
+private:
+    void enterState(sf::Sprite& sprite, int state);
+
+    const AnimationMachine* m_machine;
+    int                     m_state;
+    float                   m_timer; // Time left before moving to the next state
+    Animator                m_animator;
+};
+
+#endif // ANIMATIONCONTROLLER_HPP
@@ -0,0 +1,96 @@
+#include <stdexcept>
+#include "AnimationMachine.hpp"
+#include "utils/StringUtils.hpp"
+
+
+AnimationMachine::AnimationMachine()
+{
+}
+
+
+void AnimationMachine::addState(const std::string& name, const Animation& animation, float duration, const std::string& next)
+{
+    State state;
+    state.name = name;
+    state.animation = &animation;
+    state.duration = duration;
+    state.next_name = next;
+    state.next = -1;
+    m_states.push_back(state);
+}
+
+
+void AnimationMachine::addTransition(const std::string& from, const std::string& event, const std::string& to)
+{
+    Transition transition;
+    transition.from_name = from;
+    transition.from = -1;
+    transition.event = utils::hash(event.c_str());
+    transition.to_name = to;
+    transition.to = -1;
+    m_transitions.push_back(transition);
+}
+
+
+void AnimationMachine::resolve()
+{
+    if (m_states.empty())
+        throw std::runtime_error("Animation machine has no state");
+
+    for (State& state: m_states)
+    {
+        if (state.duration > 0)
+            state.next = findState(state.next_name);
+    }
+    for (Transition& transition: m_transitions)
+    {
+        if (!transition.from_name.empty())
+            transition.from = findState(transition.from_name);
+        transition.to = findState(transition.to_name);
+    }
+}
+
+
+const Animation& AnimationMachine::getAnimation(int state) const
+{
+    return *m_states[state].animation;
+}
+
+
+float AnimationMachine::getDuration(int state) const
+{
+    return m_states[state].duration;
+}
+
+
+int AnimationMachine::getNextState(int state) const
+{
+    return m_states[state].next;
+}
+
+
+int AnimationMachine::getTransition(int state, uint32_t event) const
+{
+    int target = -1;
+    for (const Transition& transition: m_transitions)
+    {
+        if (transition.event == event)
+        {
+            if (transition.from == state)
+                return transition.to;
+            if (transition.from == -1)
+                target = transition.to;
+        }
+    }
+    return target;
+}
+
+
+int AnimationMachine::findState(const std::string& name) const
+{
+    for (size_t i = 0; i < m_states.size(); ++i)
+        if (m_states[i].name == name)
+            return i;
+
+    throw std::runtime_error("Animation state '" + name + "' not found");
+}
@@ -0,0 +1,84 @@
+#ifndef ANIMATIONMACHINE_HPP
+#define ANIMATIONMACHINE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Animation.hpp"
+
+/**
+ * Animation state machine, loaded from the animations XML document
+ * Each state plays an animation. Events (identified by their name hash, see
+ * utils::hash) move the machine to another state, and a state with a duration
+ * moves to its next state once the duration has elapsed.
+ * Instances are driven by AnimationController.
+ */
+class AnimationMachine
+{
+public:
+    AnimationMachine();
+
+    /**
+     * Add a state, the first state added is the initial state
+     * @param duration: if greater than 0, time before moving to next state
+     * @param next: state name, required with a duration
+     */
+    void addState(const std::string& name, const Animation& animation, float duration = 0.f, const std::string& next = "");
+
+    /**
+     * Add a transition
+     * @param from: state name, or empty for a transition available from all states
+     * @param event: event name
+     * @param to: state name
+     */
+    void addTransition(const std::string& from, const std::string& event, const std::string& to);
+
+    /**
+     * Resolve state names, must be called once all states and transitions are added
+     * @throw std::runtime_error if a state name is unknown
+     */
+    void resolve();
+
+    const Animation& getAnimation(int state) const;
+
+    /**
+     * @return time before moving to the next state, 0 if the state has no duration
+     */
+    float getDuration(int state) const;
+
+    int getNextState(int state) const;
+
+    /**
+     * Find the state reached from a given state when an event occurs
+     * Transitions of the state have precedence over transitions from all states.
+     * @return target state, or -1 if the event is ignored in this state
+     */
+    int getTransition(int state, uint32_t event) const;
+
+private:
+    int findState(const std::string& name) const;
+
+    struct State
+    {
+        std::string      name;
+        const Animation* animation;
+        float            duration;
+        std::string      next_name;
+        int              next;
+    };
+
+    struct Transition
+    {
+        std::string from_name;
+        int         from; // -1 for all states
+        uint32_t    event;
+        std::string to_name;
+        int         to;
+    };
+
+    std::vector<State>      m_states;
+    std::vector<Transition> m_transitions;
+};
+
+#endif // ANIMATIONMACHINE_HPP
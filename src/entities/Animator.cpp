@@ -3,8 +3,8 @@
 
 Animator::Animator():
     m_animation(NULL),
-    m_frame(0),
-    m_timer(0.f)
+    m_phase(0),
+    m_frame(0)
 {
 }
 
@@ -26,30 +26,33 @@ void Animator::reset(sf::Sprite& sprite)
 {
     if (m_animation != NULL)
     {
-        sprite.setTexture(m_animation->getTexture());
+        // Animations often share the same texture
+        if (sprite.getTexture() != &m_animation->getTexture())
+            sprite.setTexture(m_animation->getTexture());
         setFrame(sprite, 0);
     }
 }
 
 
-void Animator::updateSubRect(sf::Sprite& sprite, float frametime)
+void Animator::updateSubRect(sf::Sprite& sprite)
 {
-    m_timer -= frametime;
-    if (m_timer <= 0)
+    size_t frame = m_animation->getCurrentFrame() + m_phase;
+    if (frame != m_frame)
     {
-        m_timer = m_animation->getDelay();
-        m_frame = (m_frame + 1) % m_animation->getFrameCount(); // Next frame
-        sprite.setTextureRect(m_animation->getFrame(m_frame));
+        m_frame = frame;
+        sprite.setTextureRect(m_animation->getFrame(frame));
     }
 }
 
 
 void Animator::setFrame(sf::Sprite& sprite, size_t index)
 {
-    if (index < m_animation->getFrameCount())
+    size_t count = m_animation->getFrameCount();
+    if (index < count)
     {
-        m_frame = index;
-        m_timer = m_animation->getDelay();
-        sprite.setTextureRect(m_animation->getFrame(index));
+        size_t current = m_animation->getCurrentFrame();
+        m_phase = (index + count - current) % count;
+        m_frame = current + m_phase;
+        sprite.setTextureRect(m_animation->getFrame(m_frame));
     }
 }
@@ -7,6 +7,8 @@
 
 /**
  * Utilitary class for associating a sprite to an animation
+ * The displayed frame follows the animation clock (see Animation::update), shifted
+ * by a phase so that the animation starts on its first frame.
  */
 class Animator
 {
@@ -20,17 +22,20 @@ public:
     void reset(sf::Sprite& sprite);
 
     /**
-     * Update texture subrect on a animated sprite
+     * Update texture subrect on a animated sprite, if the frame has changed
      * @param sprite: sprite to update
      */
-    void updateSubRect(sf::Sprite& sprite, float frametime);
+    void updateSubRect(sf::Sprite& sprite);
 
+    /**
+     * Display a frame, the animation continues from this frame
+     */
     void setFrame(sf::Sprite&, size_t index);
 
 private:
     const Animation* m_animation;
-    size_t           m_frame; // current frame index
-    float            m_timer;
+    size_t           m_phase; // Offset from the current frame of the animation clock
+    size_t           m_frame; // Displayed frame index (current frame + phase)
 };
 
 #endif // ANIMATOR_HPP
@@ -37,6 +37,7 @@ void Asteroid::onUpdate(float frametime)
 void Asteroid::onDestroy()
 {
     sf::Vector2f pos = getPosition();
+    static constexpr Resources::Key ASTEROID_BREAK("asteroid-break.ogg");
     switch (m_size)
     {
         case BIG:
@@ -47,7 +48,7 @@ void Asteroid::onDestroy()
                 asteroid->setPosition(pos);
                 EntityManager::getInstance().addEntity(asteroid);
             }
-            SoundSystem::playSound("asteroid-break.ogg", 0.5f);
+            SoundSystem::playSound(ASTEROID_BREAK, 0.5f);
             break;
         case MEDIUM:
             // Create 3 small asteroids
@@ -57,10 +58,10 @@ void Asteroid::onDestroy()
                 asteroid->setPosition(pos);
                 EntityManager::getInstance().addEntity(asteroid);
             }
-            SoundSystem::playSound("asteroid-break.ogg", 0.75f);
+            SoundSystem::playSound(ASTEROID_BREAK, 0.75f);
             break;
         default:
-            SoundSystem::playSound("asteroid-break.ogg", 1.f);
+            SoundSystem::playSound(ASTEROID_BREAK, 1.f);
             break;
     }
     EntityManager::getInstance().createImpactParticles(getPosition(), 10);
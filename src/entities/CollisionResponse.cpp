@@ -0,0 +1,72 @@
+#include "CollisionResponse.hpp"
+#include "MultiPartEntity.hpp"
+#include "Player.hpp"
+#include "PowerUp.hpp"
+#include "Projectile.hpp"
+
+CollisionResponse::Callback CollisionResponse::s_table[Entity::_TYPE_COUNT][Entity::_TYPE_COUNT];
+bool CollisionResponse::s_initialized = CollisionResponse::init();
+
+
+bool CollisionResponse::init()
+{
+    add<damageables>(Entity::DAMAGEABLE, Entity::DAMAGEABLE);
+    add<damageables>(Entity::DAMAGEABLE, Entity::PLAYER);
+    add<damageables>(Entity::PLAYER, Entity::PLAYER);
+
+    add<damageableProjectile>(Entity::DAMAGEABLE, Entity::PROJECTILE);
+    add<damageableProjectile>(Entity::PLAYER, Entity::PROJECTILE);
+
+    add<playerPowerUp>(Entity::PLAYER, Entity::POWERUP);
+
+    // Multi-part entities forward the collision to the part which is hit
+    add<multiPartDamageable>(Entity::MULTIPART, Entity::DAMAGEABLE);
+    add<multiPartDamageable>(Entity::MULTIPART, Entity::PLAYER);
+    add<multiPartProjectile>(Entity::MULTIPART, Entity::PROJECTILE);
+    return true;
+}
+
+
+template <CollisionResponse::Callback F>
+void CollisionResponse::add(Entity::TypeID a, Entity::TypeID b)
+{
+    s_table[a][b] = F;
+    if (a != b)
+        s_table[b][a] = swapped<F>;
+}
+
+
+void CollisionResponse::damageables(Entity& a, Entity& b)
+{
+    // Both entities react to the collision, b first
+    static_cast<Damageable&>(b).onCollision(static_cast<Damageable&>(a));
+    static_cast<Damageable&>(a).onCollision(static_cast<Damageable&>(b));
+}
+
+
+void CollisionResponse::damageableProjectile(Entity& a, Entity& b)
+{
+    static_cast<Damageable&>(a).onCollision(static_cast<Projectile&>(b));
+}
+
+
+void CollisionResponse::playerPowerUp(Entity& a, Entity& b)
+{
+    static_cast<Player&>(a).onCollision(static_cast<PowerUp&>(b));
+}
+
+
+void CollisionResponse::multiPartDamageable(Entity& a, Entity& b)
+{
+    MultiPartEntity::Part* part = static_cast<MultiPartEntity&>(a).hitPart(b, b.getMotion());
+    if (part != NULL)
+        part->onCollision(static_cast<Damageable&>(b));
+}
+
+
+void CollisionResponse::multiPartProjectile(Entity& a, Entity& b)
+{
+    MultiPartEntity::Part* part = static_cast<MultiPartEntity&>(a).hitPart(b, b.getMotion());
+    if (part != NULL)
+        part->onCollision(static_cast<Projectile&>(b));
+}
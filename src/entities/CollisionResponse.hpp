@@ -0,0 +1,61 @@
+#ifndef COLLISIONRESPONSE_HPP
+#define COLLISIONRESPONSE_HPP
+
+#include "Entity.hpp"
+
+/**
+ * Static class for the reaction of colliding entities
+ * Responses are stored in a table indexed by the type IDs of both entities, so
+ * pairs without response can be skipped before testing the collision.
+ */
+class CollisionResponse
+{
+public:
+    /**
+     * Response function, called with colliding entities
+     */
+    typedef void (*Callback)(Entity& a, Entity& b);
+
+    /**
+     * @return true if entities of types a and b react when colliding
+     */
+    static inline bool exists(Entity::TypeID a, Entity::TypeID b)
+    {
+        return s_table[a][b] != NULL;
+    }
+
+    /**
+     * Apply the response of colliding entities a and b (response must exist)
+     */
+    static inline void apply(Entity& a, Entity& b)
+    {
+        s_table[a.getTypeID()][b.getTypeID()](a, b);
+    }
+
+private:
+    /**
+     * Fill the response table
+     */
+    static bool init();
+
+    /**
+     * Register response for (a, b), and the mirrored response for (b, a)
+     */
+    template <Callback F>
+    static void add(Entity::TypeID a, Entity::TypeID b);
+
+    template <Callback F>
+    static void swapped(Entity& a, Entity& b) { F(b, a); }
+
+    // Responses, arguments are ordered as in the registered type IDs
+    static void damageables(Entity& a, Entity& b);
+    static void damageableProjectile(Entity& a, Entity& b);
+    static void playerPowerUp(Entity& a, Entity& b);
+    static void multiPartDamageable(Entity& a, Entity& b);
+    static void multiPartProjectile(Entity& a, Entity& b);
+
+    static Callback s_table[Entity::_TYPE_COUNT][Entity::_TYPE_COUNT];
+    static bool     s_initialized;
+};
+
+#endif // COLLISIONRESPONSE_HPP
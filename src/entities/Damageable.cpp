@@ -2,6 +2,7 @@
 #include "Projectile.hpp"
 #include "Explosion.hpp"
 #include "EntityManager.hpp"
+#include "core/Collisions.hpp"
 #include "core/ParticleSystem.hpp"
 
 #define FLASH_DELAY 0.3f
@@ -9,14 +10,15 @@
 
 Damageable::Damageable():
     m_hp(1),
-    m_flash_timer(0)
+    m_flash_time(-FLASH_DELAY)
 {
+    setTypeID(Entity::DAMAGEABLE);
 }
 
 
-void Damageable::collides(Entity& entity)
+Damageable* Damageable::hitTest(const sf::Sprite& sprite, const sf::Vector2f& motion)
 {
-    entity.onCollision(*this);
+    return Collisions::sweptTest(sprite, motion, *this, getMotion()) ? this : NULL;
 }
 
 
@@ -88,21 +90,44 @@ int Damageable::updateHP(int diff)
 
 void Damageable::initDamageFlash()
 {
-    if (m_flash_timer <= 0)
-        m_flash_timer = FLASH_DELAY;
+    float now = EntityManager::getInstance().getTimer();
+    if (now - m_flash_time >= FLASH_DELAY || now < m_flash_time)
+        m_flash_time = now;
 }
 
 
-void Damageable::updateDamageFlash(float frametime)
+void Damageable::clearDamageFlash()
 {
-    if (m_flash_timer >= 0)
+    m_flash_time = -FLASH_DELAY;
+}
+
+
+void Damageable::drawWithFlash(sf::RenderTarget& target, sf::RenderStates states) const
+{
+    // Timer is reset when a level starts
+    float elapsed = EntityManager::getInstance().getTimer() - m_flash_time;
+    if (elapsed < 0 || elapsed >= FLASH_DELAY || getTexture() == NULL)
     {
-        m_flash_timer -= frametime;
-        int value = 255 - (255 * m_flash_timer / FLASH_DELAY);
-        setColor(sf::Color(255, value, value));
-        if (m_flash_timer <= 0)
-        {
-            setColor(sf::Color::White);
-        }
+        target.draw(*this, states);
+        return;
     }
+
+    // Same quad as the sprite, with a red vertex color fading to white
+    sf::Uint8 value = 255 * elapsed / FLASH_DELAY;
+    sf::Color color(255, value, value);
+    sf::FloatRect bounds = getLocalBounds();
+    const sf::IntRect& rect = getTextureRect();
+    float left = rect.left;
+    float right = left + rect.width;
+    float top = rect.top;
+    float bottom = top + rect.height;
+    const sf::Vertex vertices[] = {
+        sf::Vertex(sf::Vector2f(0, 0), color, sf::Vector2f(left, top)),
+        sf::Vertex(sf::Vector2f(0, bounds.height), color, sf::Vector2f(left, bottom)),
+        sf::Vertex(sf::Vector2f(bounds.width, 0), color, sf::Vector2f(right, top)),
+        sf::Vertex(sf::Vector2f(bounds.width, bounds.height), color, sf::Vector2f(right, bottom))
+    };
+    states.transform *= getTransform();
+    states.texture = getTexture();
+    target.draw(vertices, 4, sf::TrianglesStrip, states);
 }
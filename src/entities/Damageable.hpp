@@ -3,6 +3,8 @@
 
 #include "Entity.hpp"
 
+class Projectile;
+
 /**
  * Base class for damageable entities with hit points
  */
@@ -11,7 +13,7 @@ class Damageable: public Entity
 public:
     Damageable();
 
-    virtual void collides(Entity& entity);
+    Damageable* hitTest(const sf::Sprite& sprite, const sf::Vector2f& motion) override;
 
     virtual void takeDamage(int damage);
 
@@ -24,16 +26,23 @@ public:
     void onDestroy();
 
     void initDamageFlash();
+
+    /**
+     * Draw the entity, tinted in red during a damage flash
+     * Flashes are evaluated from their start time when drawing, the sprite itself is
+     * never modified: entities which aren't flashing are drawn as regular sprites.
+     */
+    void drawWithFlash(sf::RenderTarget& target, sf::RenderStates states) const;
+
 protected:
     void setHP(int hp);
     int updateHP(int diff);
 
-
-    void updateDamageFlash(float frametime);
+    void clearDamageFlash();
 
 private:
     int   m_hp;
-    float m_flash_timer;
+    float m_flash_time; // EntityManager time when the damage flash started
 };
 
 #endif // DAMAGEABLE_HPP
@@ -1,10 +1,14 @@
 #include "Entity.hpp"
 #include "core/Collisions.hpp"
 
+uint32_t Entity::s_next_serial = 0;
+
 
 Entity::Entity():
+    m_serial(s_next_serial++),
     m_dead(false),
-    m_team(NEUTRAL)
+    m_team(NEUTRAL),
+    m_type_id(DUMMY)
 {
 }
 
@@ -34,6 +38,12 @@ void Entity::setTeam(Team team)
 }
 
 
+void Entity::setTypeID(TypeID type_id)
+{
+    m_type_id = type_id;
+}
+
+
 sf::FloatRect Entity::getBoundingBox() const
 {
     sf::Vector2f pos = getPosition() - getOrigin();
@@ -1,11 +1,10 @@
 #ifndef ENTITY_HPP
 #define ENTITY_HPP
 
+#include <cstdint>
 #include <SFML/Graphics.hpp>
 
 class Damageable;
-class PowerUp;
-class Projectile;
 
 /**
  * Abstract base class for game objects
@@ -18,6 +17,21 @@ public:
         GOOD, NEUTRAL, BAD
     };
 
+    /**
+     * Entity type tag, selects the collision response (see CollisionResponse)
+     * DAMAGEABLE and PLAYER entities are drawn with their damage flash.
+     */
+    enum TypeID
+    {
+        DUMMY,      // No collision response
+        DAMAGEABLE,
+        PLAYER,
+        PROJECTILE,
+        POWERUP,
+        MULTIPART,
+        _TYPE_COUNT // INTERNAL USE
+    };
+
     Entity();
 
     /**
@@ -32,8 +46,19 @@ public:
 
     Team getTeam() const;
 
-    // implement to trigger collision callbacks
-    virtual void collides(Entity& entity) = 0;
+    inline TypeID getTypeID() const { return static_cast<TypeID>(m_type_id); }
+
+    /**
+     * Unique number of the entity, unlike its address it is never reused
+     */
+    inline uint32_t getSerial() const { return m_serial; }
+
+    /**
+     * Find the damageable entity hit by a sprite (see ProjectileSystem)
+     * @param motion: displacement of the sprite since the previous frame
+     * @return entity hit, or NULL if entity cannot be damaged or isn't hit
+     */
+    virtual Damageable* hitTest(const sf::Sprite&, const sf::Vector2f&) { return NULL; }
 
     /**
      * Register texture for pixel-perfect collision when attached to sprite
@@ -58,11 +83,6 @@ public:
      */
     virtual void onDestroy() {}
 
-    virtual void onCollision(Entity&)     {}
-    virtual void onCollision(Damageable&) {}
-    virtual void onCollision(PowerUp&)    {}
-    virtual void onCollision(Projectile&) {}
-
     // helpers -----------------------------------------------------------------
 
     sf::FloatRect getBoundingBox() const;
@@ -77,6 +97,12 @@ public:
 
     sf::Vector2f getCenter() const;
 
+    /**
+     * Displacement during the last update, used for continuous collision detection
+     * Fast entities override it, so they cannot pass through other entities.
+     */
+    virtual sf::Vector2f getMotion() const { return sf::Vector2f(); }
+
     // ugly hacks --------------------------------------------------------------
 
     virtual float getSpeedX() const { return 0.f; }
@@ -85,9 +111,15 @@ public:
 protected:
     void setTeam(Team team);
 
+    void setTypeID(TypeID type_id);
+
 private:
-    bool m_dead;
-    Team m_team;
+    static uint32_t s_next_serial;
+
+    uint32_t m_serial;
+    bool     m_dead;
+    Team     m_team;
+    uint8_t  m_type_id;
 };
 
 #endif // ENTITY_HPP
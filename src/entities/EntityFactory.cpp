@@ -0,0 +1,72 @@
+#include <iostream>
+#include <stdexcept>
+#include "EntityFactory.hpp"
+#include "bosses/BrainBoss.hpp"
+#include "bosses/EvilBoss.hpp"
+#include "bosses/FlyingSaucerBoss.hpp"
+#include "bosses/TentaculatBoss.hpp"
+#include "decors/Canon.hpp"
+#include "decors/Gate.hpp"
+#include "decors/GunTower.hpp"
+#include "utils/StringUtils.hpp"
+
+
+EntityFactory& EntityFactory::getInstance()
+{
+    static EntityFactory self;
+    return self;
+}
+
+
+EntityFactory::EntityFactory()
+{
+    add<TentaculatBoss>("boss", "tentaculat");
+    add<FlyingSaucerBoss>("boss", "flying-saucer");
+    add<BrainBoss>("boss", "brain");
+    add<EvilBoss>("boss", "evil");
+
+    add<Gate>("decor", "gate");
+    add<Canon>("decor", "canon");
+    add<GunTower>("decor", "guntower");
+}
+
+
+int EntityFactory::add(const char* tag, const char* id, Creator creator)
+{
+    uint32_t key = makeKey(tag, id);
+    std::unordered_map<uint32_t, Kind>::const_iterator it = m_kinds.find(key);
+    if (it != m_kinds.end())
+    {
+        const Kind& kind = it->second;
+        if (kind.tag != tag || kind.id != id)
+            throw std::runtime_error("Entity kind hash collision between " + kind.tag + " '" + kind.id
+                                     + "' and " + tag + " '" + id + "'");
+
+        std::cerr << "[entities] " << tag << " '" << id << "' registered twice, replaced" << std::endl;
+        m_creators[kind.index] = creator;
+        return kind.index;
+    }
+
+    Kind& kind = m_kinds[key];
+    kind.tag = tag;
+    kind.id = id;
+    kind.index = m_creators.size();
+    m_creators.push_back(creator);
+    return kind.index;
+}
+
+
+int EntityFactory::find(const char* tag, const char* id) const
+{
+    std::unordered_map<uint32_t, Kind>::const_iterator it = m_kinds.find(makeKey(tag, id));
+    if (it == m_kinds.end() || it->second.tag != tag || it->second.id != id)
+        return -1;
+
+    return it->second.index;
+}
+
+
+uint32_t EntityFactory::makeKey(const char* tag, const char* id)
+{
+    return utils::hash(id, utils::hash("/", utils::hash(tag)));
+}
@@ -0,0 +1,66 @@
+#ifndef ENTITYFACTORY_HPP
+#define ENTITYFACTORY_HPP
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Entity;
+
+/**
+ * Singleton registry of the entity kinds which can be placed in levels (bosses,
+ * decors...), identified by their level tag name and their id attribute
+ * Kinds are resolved to an index once, then entities are created by index.
+ */
+class EntityFactory
+{
+public:
+    typedef Entity* (*Creator)();
+
+    static EntityFactory& getInstance();
+
+    /**
+     * Register an entity kind, replacing the previous one with the same tag and id
+     * @param tag: tag name in the levels file
+     * @param id: value of the id attribute
+     * @return index of the kind
+     * @throw std::runtime_error if another kind has the same key hash
+     */
+    int add(const char* tag, const char* id, Creator creator);
+
+    template <class T>
+    inline int add(const char* tag, const char* id) { return add(tag, id, &construct<T>); }
+
+    /**
+     * @return index of the entity kind, or -1 if not registered
+     */
+    int find(const char* tag, const char* id) const;
+
+    /**
+     * Allocate a new entity
+     * @param index: index of the kind, returned by find
+     */
+    inline Entity* create(int index) const { return m_creators[index](); }
+
+private:
+    EntityFactory();
+    EntityFactory(const EntityFactory&);
+
+    template <class T>
+    static Entity* construct() { return new T(); }
+
+    static uint32_t makeKey(const char* tag, const char* id);
+
+    struct Kind
+    {
+        std::string tag;
+        std::string id;
+        int         index;
+    };
+
+    std::vector<Creator>               m_creators;
+    std::unordered_map<uint32_t, Kind> m_kinds; // Indexed by key, tag and id resolve hash collisions
+};
+
+#endif // ENTITYFACTORY_HPP
@@ -3,29 +3,33 @@
 #include <cassert>
 #include "EntityManager.hpp"
 #include "Asteroid.hpp"
+#include "CollisionResponse.hpp"
 #include "Player.hpp"
 #include "Spaceship.hpp"
 #include "core/LevelManager.hpp"
+#include "core/Constants.hpp"
 #include "core/ControlPanel.hpp"
 #include "core/ParticleSystem.hpp"
 #include "core/MessageSystem.hpp"
 #include "core/Resources.hpp"
+#include "core/SoundSystem.hpp"
 #include "core/Collisions.hpp"
 #include "vendor/tinyxml/tinyxml2.h"
 
+// Seconds simulated before the target time when seeking, and simulation step
+#define SEEK_PREROLL 5.f
+#define SEEK_STEP    (1 / 60.f)
+
 
 /**
  * Get attack pattern encoded in an xml element
  */
 static Spaceship::AttackPattern parse_attack_pattern(const tinyxml2::XMLElement* elem)
 {
-    if (elem->Attribute("attack", "auto_aim")) return Spaceship::AUTO_AIM;
-    if (elem->Attribute("attack", "on_sight")) return Spaceship::ON_SIGHT;
-    if (elem->Attribute("attack", "none")    ) return Spaceship::NONE;
-
-    if (elem->Attribute("attack") != NULL)
+    Spaceship::AttackPattern attack = Spaceship::NONE;
+    if (!Spaceship::parseAttackPattern(elem->Attribute("attack"), attack) && elem->Attribute("attack") != NULL)
         std::cerr << "unknown attack pattern: " << elem->Attribute("attack") << std::endl;
-    return Spaceship::NONE;
+    return attack;
 }
 
 /**
@@ -33,14 +37,29 @@ static Spaceship::AttackPattern parse_attack_pattern(const tinyxml2::XMLElement*
  */
 static Spaceship::MovementPattern parse_movement_pattern(const tinyxml2::XMLElement* elem)
 {
-    if (elem->Attribute("move", "line")  ) return Spaceship::LINE;
-    if (elem->Attribute("move", "magnet")) return Spaceship::MAGNET;
-    if (elem->Attribute("move", "sinus") ) return Spaceship::SINUS;
-    if (elem->Attribute("move", "circle")) return Spaceship::CIRCLE;
-
-    if (elem->Attribute("move") != NULL)
+    Spaceship::MovementPattern movement = Spaceship::LINE;
+    if (!Spaceship::parseMovementPattern(elem->Attribute("move"), movement) && elem->Attribute("move") != NULL)
         std::cerr << "unknown movement pattern: " << elem->Attribute("move") << std::endl;
-    return Spaceship::LINE;
+    return movement;
+}
+
+/**
+ * Add the transitions ('on' tags) children of an xml element to an animation machine
+ * @param from: state name, or empty for transitions from all states
+ */
+static void parse_transitions(AnimationMachine& machine, const tinyxml2::XMLElement* elem, const char* from)
+{
+    const tinyxml2::XMLElement* on = elem->FirstChildElement("on");
+    while (on != NULL)
+    {
+        const char* event = on->Attribute("event");
+        const char* to = on->Attribute("to");
+        if (event == NULL || to == NULL)
+            throw std::runtime_error("XML error: machine.on.event or machine.on.to is missing");
+
+        machine.addTransition(from, event, to);
+        on = on->NextSiblingElement("on");
+    }
 }
 
 
@@ -54,8 +73,9 @@ EntityManager& EntityManager::getInstance()
 EntityManager::EntityManager():
     m_timer(0),
     m_player(NULL),
-    m_width(0),
-    m_height(0),
+    // Default universe size, the game doesn't always start with the intro screen
+    m_width(APP_WIDTH),
+    m_height(APP_HEIGHT - ControlPanel::HEIGHT),
     m_decor_height(0),
     m_levels(LevelManager::getInstance()),
     m_particles(ParticleSystem::getInstance())
@@ -93,15 +113,16 @@ EntityManager::~EntityManager()
 }
 
 
-void EntityManager::initialize()
+void EntityManager::initialize(bool reset_player)
 {
     // re-init particles
     m_particles.clear();
+    m_projectiles.clear();
     MessageSystem::clear();
 
     ControlPanel::getInstance().setLevelDuration(m_levels.getDuration());
     // le vaisseau du joueur est conservé d'un niveau à l'autre
-    if (m_player == NULL || m_player->getHP() <= 0)
+    if (m_player == NULL || m_player->getHP() <= 0 || reset_player)
     {
         respawnPlayer();
     }
@@ -151,7 +172,40 @@ void EntityManager::initialize()
         SoundSystem::stopMusic();
     }
 
+    // Frames displayed are used by collision tests: levels must always start from
+    // the same animation state, whatever was played before (replays, benchmark)
     m_timer = 0.f;
+    for (AnimationMap::value_type& animation: m_animations)
+        animation.second.reset();
+}
+
+
+void EntityManager::seek(float time)
+{
+    m_timer = std::max(0.f, time - SEEK_PREROLL);
+    m_levels.skipSpawnQueue(m_timer);
+
+    // Skipped seconds must be silent
+    bool sound = SoundSystem::isSoundEnabled();
+    SoundSystem::enableSound(false);
+
+    // Nobody steers the player meanwhile: protect it, and restore its state afterwards
+    const sf::Vector2f position = m_player->getPosition();
+    const int hp = m_player->getHP();
+    const int score = m_player->getScore();
+    m_player->setInvulnerable(true);
+    while (m_timer < time)
+    {
+        if (spawnBadGuys())
+            break;
+        update(std::min(SEEK_STEP, time - m_timer));
+    }
+    m_player->setInvulnerable(false);
+    m_player->setPosition(position);
+    m_player->restoreHP(hp);
+    m_player->updateScore(score - m_player->getScore());
+
+    SoundSystem::enableSound(sound);
 }
 
 
@@ -166,6 +220,12 @@ void EntityManager::update(float frametime)
 {
     EntityList::iterator it, it2;
 
+    // Advance animations once, for all their instances
+    for (AnimationMap::value_type& animation: m_animations)
+        animation.second.update(frametime);
+
+    updateSleepingEntities(frametime);
+
     // Update and collision
     for (it = m_entities.begin(); it != m_entities.end();)
     {
@@ -190,17 +250,20 @@ void EntityManager::update(float frametime)
             it2 = it;
             for (++it2; it2 != m_entities.end(); ++it2)
             {
-                // Collision dectection it1 <-> it2
-                if (Collisions::pixelPerfectTest(entity, **it2))
+                // Collision dectection it1 <-> it2, if the entities react to each other
+                Entity& other = **it2;
+                if (CollisionResponse::exists(entity.getTypeID(), other.getTypeID())
+                    && Collisions::sweptTest(entity, entity.getMotion(), other, other.getMotion()))
                 {
-                    entity.collides(**it2);
-                    (**it2).collides(entity);
+                    CollisionResponse::apply(entity, other);
                 }
             }
             ++it;
         }
     }
 
+    m_projectiles.update(frametime, m_entities, m_width, m_height);
+
     // HACK: decor height applies only on player
     if (m_decor_height > 0)
     {
@@ -228,9 +291,36 @@ void EntityManager::update(float frametime)
 }
 
 
+void EntityManager::updateSleepingEntities(float frametime)
+{
+    for (EntityList::iterator it = m_sleeping_entities.begin(); it != m_sleeping_entities.end();)
+    {
+        Entity& entity = **it;
+        entity.move(-FOREGROUND_SPEED * frametime, 0);
+        if (entity.getBoundingBox().left < m_width)
+        {
+            // Entity enters the view, move it to the active list
+            EntityList::iterator next = it;
+            ++next;
+            m_entities.splice(m_entities.end(), m_sleeping_entities, it);
+            it = next;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+
 void EntityManager::addEntity(Entity* entity)
 {
     entity->onInit();
+    if (entity->getBoundingBox().left >= m_width)
+    {
+        m_sleeping_entities.push_back(entity);
+        return;
+    }
     m_entities.push_back(entity);
 }
 
@@ -242,6 +332,18 @@ void EntityManager::clearEntities()
         delete *it;
     }
     m_entities.clear();
+    for (EntityList::iterator it = m_sleeping_entities.begin(); it != m_sleeping_entities.end(); ++it)
+    {
+        delete *it;
+    }
+    m_sleeping_entities.clear();
+    m_projectiles.clear();
+}
+
+
+size_t EntityManager::getEntityCount() const
+{
+    return m_entities.size() + m_sleeping_entities.size() + m_projectiles.getCount();
 }
 
 
@@ -266,8 +368,13 @@ void EntityManager::draw(sf::RenderTarget& target, sf::RenderStates states) cons
     // Draw managed entities
     for (EntityList::const_iterator it = m_entities.begin(); it != m_entities.end(); ++it)
     {
-        target.draw(**it, states);
+        const Entity& entity = **it;
+        if (entity.getTypeID() == Entity::DAMAGEABLE || entity.getTypeID() == Entity::PLAYER)
+            static_cast<const Damageable&>(entity).drawWithFlash(target, states);
+        else
+            target.draw(entity, states);
     }
+    target.draw(m_projectiles, states);
 }
 
 
@@ -281,6 +388,9 @@ void EntityManager::loadAnimations(const std::string& filename)
         throw std::runtime_error(error);
     }
 
+    // Texture of each animation, textures are loaded once all animations are parsed
+    std::vector<std::pair<Animation*, std::string>> textures;
+
     tinyxml2::XMLElement* elem = doc.RootElement()->FirstChildElement("anim");
     while (elem != NULL)
     {
@@ -309,11 +419,56 @@ void EntityManager::loadAnimations(const std::string& filename)
                 animation.addFrame({x + i * width, y, width, height});
 
             animation.setDelay(delay);
-            animation.setTexture(Resources::getTexture(img));
-            Collisions::registerTexture(&animation.getTexture());
+            textures.push_back(std::make_pair(&animation, img));
         }
         elem = elem->NextSiblingElement("anim");
     }
+
+    // Decode images in parallel
+    std::vector<std::string> names;
+    for (const auto& texture: textures)
+        names.push_back(texture.second);
+    Resources::loadTextures(names);
+
+    for (const auto& texture: textures)
+    {
+        texture.first->setTexture(Resources::getTexture(texture.second));
+        Collisions::registerTexture(&texture.first->getTexture());
+    }
+
+    // Parse animation state machines
+    elem = doc.RootElement()->FirstChildElement("machine");
+    while (elem != NULL)
+    {
+        const char* name = elem->Attribute("name");
+        if (name == NULL)
+            throw std::runtime_error("XML error: machine.name is missing");
+
+        AnimationMachine& machine = m_animation_machines[name];
+        tinyxml2::XMLElement* state = elem->FirstChildElement("state");
+        while (state != NULL)
+        {
+            const char* state_name = state->Attribute("name");
+            const char* anim = state->Attribute("anim");
+            if (state_name == NULL || anim == NULL)
+                throw std::runtime_error("XML error: machine.state.name or machine.state.anim is missing");
+
+            float duration = 0.f;
+            state->QueryFloatAttribute("duration", &duration);
+            const char* next = state->Attribute("next");
+            if (duration > 0 && next == NULL)
+                throw std::runtime_error("XML error: machine.state.next is missing");
+
+            machine.addState(state_name, getAnimation(anim), duration, next != NULL ? next : "");
+            parse_transitions(machine, state, state_name);
+            state = state->NextSiblingElement("state");
+        }
+        // Transitions outside a state are available from all states
+        parse_transitions(machine, elem, "");
+        machine.resolve();
+
+        elem = elem->NextSiblingElement("machine");
+    }
 }
 
 
@@ -327,6 +482,16 @@ const Animation& EntityManager::getAnimation(const std::string& id) const
 }
 
 
+const AnimationMachine& EntityManager::getAnimationMachine(const std::string& id) const
+{
+    AnimationMachineMap::const_iterator it = m_animation_machines.find(id);
+    if (it == m_animation_machines.end())
+        throw std::runtime_error("Animation machine '" + id + "' not found");
+
+    return it->second;
+}
+
+
 void EntityManager::loadWeapons(const std::string& filename)
 {
     // Open XML document
@@ -431,11 +596,14 @@ void EntityManager::loadSpaceships(const std::string& filename)
         int points = 0;
         elem->QueryIntAttribute("points", &points);
 
-        // Create spaceship instance
-        Spaceship ship(getAnimation(animation), hp, speed);
-        ship.setPoints(points);
-        ship.setMovementPattern(parse_movement_pattern(elem));
-        ship.setAttackPattern(parse_attack_pattern(elem));
+        // Create spaceship profile
+        Spaceship::Profile profile;
+        profile.animation = &getAnimation(animation);
+        profile.hp = hp;
+        profile.speed = speed;
+        profile.points = points;
+        profile.movement = parse_movement_pattern(elem);
+        profile.attack = parse_attack_pattern(elem);
 
         // Parse weapon tag
         tinyxml2::XMLElement* weapon = elem->FirstChildElement("weapon");
@@ -452,34 +620,42 @@ void EntityManager::loadSpaceships(const std::string& filename)
             if (weapon->QueryIntAttribute("y", &wy) != tinyxml2::XML_SUCCESS)
                 throw std::runtime_error("XML error: spaceship.weapon.y is missing");
 
-            ship.getWeapon().init(weapon_id);
-            ship.getWeapon().setPosition(wx, wy);
+            profile.weapon.init(weapon_id);
+            profile.weapon.setPosition(wx, wy);
         }
 
         // Parse engine tag
         tinyxml2::XMLElement* engine = elem->FirstChildElement("engine");
         if (engine != NULL) {
-            sf::Vector2f engine_offset;
-            engine->QueryFloatAttribute("x", &engine_offset.x);
-            engine->QueryFloatAttribute("y", &engine_offset.y);
-            ship.enableEngineEffect(engine_offset);
+            profile.engine_effect = true;
+            engine->QueryFloatAttribute("x", &profile.engine_offset.x);
+            engine->QueryFloatAttribute("y", &profile.engine_offset.y);
         }
 
-        // Insert spaceship in Spaceship map
-        m_spaceships.emplace(id, ship);
+        // Insert profile, indexed by its ID
+        m_spaceship_ids[id] = m_spaceship_profiles.size();
+        m_spaceship_profiles.push_back(profile);
 
         elem = elem->NextSiblingElement("spaceship");
     }
 }
 
 
-Spaceship* EntityManager::createSpaceship(const std::string& id) const
+int EntityManager::getSpaceshipProfileID(const std::string& id) const
 {
-    SpaceshipMap::const_iterator it = m_spaceships.find(id);
-    if (it == m_spaceships.end())
-        std::cerr << "Cannot create spaceship with id '" << id << "'" << std::endl;
+    std::map<std::string, int>::const_iterator it = m_spaceship_ids.find(id);
+    if (it == m_spaceship_ids.end())
+    {
+        std::cerr << "Cannot find spaceship with id '" << id << "'" << std::endl;
+        return -1;
+    }
+    return it->second;
+}
 
-    return it->second.clone();
+
+Spaceship* EntityManager::createSpaceship(int profile_id) const
+{
+    return new Spaceship(m_spaceship_profiles[profile_id]);
 }
 
 
@@ -503,7 +679,7 @@ bool EntityManager::spawnEntities()
 
     // The current level is completed when there is no remaining entities in the
     // LevelManager's spawn queue and Player is the only entity still active
-    return m_levels.getSpawnQueueSize() > 0 || m_entities.size() > 1;
+    return m_levels.getSpawnQueueSize() > 0 || m_entities.size() > 1 || !m_sleeping_entities.empty();
 }
 
 
@@ -533,8 +709,8 @@ void EntityManager::createGreenParticles(const sf::Vector2f& pos, size_t count)
 
 void EntityManager::StarsEmitter::onParticleCreated(ParticleSystem::Particle& particle) const
 {
-    particle.position.x = math::rand(0, EntityManager::getInstance().getWidth());
-    particle.position.y = math::rand(0, EntityManager::getInstance().getHeight());
+    particle.position.x = math::rand(0, EntityManager::getInstance().getWidth(), math::PARTICLES);
+    particle.position.y = math::rand(0, EntityManager::getInstance().getHeight(), math::PARTICLES);
 }
 
 
@@ -9,7 +9,9 @@
 
 #include "Weapon.hpp"
 #include "Animation.hpp"
+#include "AnimationMachine.hpp"
 #include "Spaceship.hpp"
+#include "ProjectileSystem.hpp"
 #include "core/ParticleSystem.hpp"
 
 class LevelManager;
@@ -23,6 +25,8 @@ class Player;
 class EntityManager: public sf::Drawable, public sf::Transformable
 {
 public:
+    typedef std::list<Entity*> EntityList;
+
     // background image speed for parallax scrolling
     static const int BACKGROUND_SPEED = 20;
     static const int FOREGROUND_SPEED = 80;
@@ -32,7 +36,20 @@ public:
      */
     static EntityManager& getInstance();
 
-    void initialize();
+    /**
+     * Prepare the current level
+     * @param reset_player: start with a new player instead of keeping the current one
+     */
+    void initialize(bool reset_player = false);
+
+    /**
+     * Jump to a given time in the current level, must be called after initialize
+     * Entities spawning before the last seconds are skipped, and these last seconds
+     * are simulated at once, without rendering, so the scene is populated. The player
+     * can't be damaged meanwhile, and gets back its position, hit points and score.
+     * @param time: elapsed time in seconds in the level
+     */
+    void seek(float time);
 
     /**
      * Resize the universe dimensions
@@ -72,7 +89,31 @@ public:
     void clearEntities();
 
     /**
-     * Load animation definitions
+     * Number of managed entities, including player, lasers and sleeping entities
+     */
+    size_t getEntityCount() const;
+
+    /**
+     * Number of sleeping entities skipped during the last update
+     */
+    inline size_t getCulledCount() const { return m_sleeping_entities.size(); }
+
+    /**
+     * Lasers fired by weapons
+     */
+    inline ProjectileSystem& getProjectiles() { return m_projectiles; }
+    inline const ProjectileSystem& getProjectiles() const { return m_projectiles; }
+
+    /**
+     * Active entities, including player
+     * Entities inserted ahead of the view are sleeping: they scroll with the
+     * foreground until they enter the view, and aren't updated, drawn or tested
+     * for collisions until then.
+     */
+    inline const EntityList& getEntities() const { return m_entities; }
+
+    /**
+     * Load animation and animation state machine definitions
      * @param filename: path to XML document
      */
     void loadAnimations(const std::string& filename);
@@ -83,6 +124,12 @@ public:
      */
     const Animation& getAnimation(const std::string& id) const;
 
+    /**
+     * Get an animation state machine
+     * @param id: machine ID from XML document
+     */
+    const AnimationMachine& getAnimationMachine(const std::string& id) const;
+
     /**
      * Load weapon definitions
      * @param filename path to XML document
@@ -102,11 +149,18 @@ public:
     void loadSpaceships(const std::string& filename);
 
     /**
-     * Allocate a new Spaceship with a given profile
+     * Get the profile ID of a spaceship type, resolve it once before creating spaceships
      * @param id: spaceship type ID from XML document
+     * @return profile ID, or -1 if spaceship type is unknown
+     */
+    int getSpaceshipProfileID(const std::string& id) const;
+
+    /**
+     * Allocate a new Spaceship with a given profile
+     * @param profile_id: valid profile ID, see getSpaceshipProfileID
      * @return new allocated spaceship
      */
-    Spaceship* createSpaceship(const std::string& id) const;
+    Spaceship* createSpaceship(int profile_id) const;
 
     /**
      * Get player entity
@@ -130,17 +184,27 @@ private:
      */
     void respawnPlayer();
 
-    typedef std::list<Entity*> EntityList;
-    EntityList m_entities;
+    /**
+     * Scroll sleeping entities, and activate those entering the view
+     */
+    void updateSleepingEntities(float frametime);
+
+    EntityList       m_entities;
+    EntityList       m_sleeping_entities; // Entities ahead of the view
+    ProjectileSystem m_projectiles;
 
     typedef std::map<std::string, Animation> AnimationMap;
     AnimationMap m_animations;
 
+    typedef std::map<std::string, AnimationMachine> AnimationMachineMap;
+    AnimationMachineMap m_animation_machines;
+
     typedef std::map<std::string, Weapon> WeaponMap;
     WeaponMap m_weapons;
 
-    typedef std::map<std::string, Spaceship> SpaceshipMap;
-    SpaceshipMap m_spaceships; // ID-indexed spaceships
+    // Spaceship profiles, indexed by profile ID (never modified once loaded)
+    std::vector<Spaceship::Profile> m_spaceship_profiles;
+    std::map<std::string, int>      m_spaceship_ids;
 
     float         m_timer;
     Player*       m_player;
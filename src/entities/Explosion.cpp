@@ -3,27 +3,24 @@
 #include "core/SoundSystem.hpp"
 
 
-Explosion::Explosion()
+Explosion::Explosion():
+    m_elapsed(0.f)
 {
     m_animator.setAnimation(*this, EntityManager::getInstance().getAnimation("explosion"));
-    SoundSystem::playSound("boom.ogg");
+    static constexpr Resources::Key BOOM("boom.ogg");
+    SoundSystem::playSound(BOOM);
 
     setOrigin(getWidth() / 2, getHeight() / 2);
 }
 
 
-void Explosion::collides(Entity& entity)
-{
-    entity.onCollision(*this);
-}
-
-
 void Explosion::onUpdate(float frametime)
 {
     move(-EntityManager::FOREGROUND_SPEED * frametime, 0);
 
-    m_animator.updateSubRect(*this, frametime);
-    if (m_clock.getElapsedTime().asSeconds() > m_animator.getAnimation()->getDuration())
+    m_animator.updateSubRect(*this);
+    m_elapsed += frametime;
+    if (m_elapsed > m_animator.getAnimation()->getDuration())
     {
         kill();
     }
@@ -12,13 +12,12 @@ class Explosion: public Entity
 public:
     Explosion();
 
-    void collides(Entity& entity);
 
     void onUpdate(float frametime);
 
 private:
     Animator  m_animator;
-    sf::Clock m_clock;
+    float     m_elapsed;
 };
 
 #endif // EXPLOSION_HPP
@@ -35,14 +35,14 @@ void Missile::onUpdate(float frametime)
 
 void Missile::onDestroy()
 {
+    static constexpr Resources::Key LASER_RED("ammo/laser-red.png");
+    const sf::Texture& texture = Resources::getTexture(LASER_RED);
     for (int i = 0; i < 20; ++i)
     {
         float angle = math::rand(m_angle - math::PI / 2, m_angle + math::PI / 2);
         float speed = math::rand(200, 600);
 
-        Projectile* p = new Projectile(m_owner, angle, Resources::getTexture("ammo/laser-red.png"), speed, 10);
-        p->setPosition(getPosition());
-        EntityManager::getInstance().addEntity(p);
+        EntityManager::getInstance().getProjectiles().add(*m_owner, getPosition(), angle, texture, speed, 10);
     }
 }
 
@@ -7,10 +7,21 @@
 MultiPartEntity::MultiPartEntity()
 {
     setTeam(Entity::NEUTRAL);
+    setTypeID(Entity::MULTIPART);
 }
 
 
-void MultiPartEntity::collides(Entity& entity)
+Damageable* MultiPartEntity::hitTest(const sf::Sprite& sprite, const sf::Vector2f& motion)
+{
+    // The texture rect covers all parts
+    if (!Collisions::sweptTest(sprite, motion, *this, getMotion()))
+        return NULL;
+
+    return hitPart(sprite, motion);
+}
+
+
+MultiPartEntity::Part* MultiPartEntity::hitPart(const sf::Sprite& sprite, const sf::Vector2f& motion)
 {
     // Reverse it because elements drawn on top need to be checked first
     for (PartVector::reverse_iterator part = m_parts.rbegin(); part != m_parts.rend(); ++part)
@@ -21,25 +32,14 @@ void MultiPartEntity::collides(Entity& entity)
             // so we need to move the part to its absolute position to test the collision
             sf::Vector2f relative_pos = part->getPosition();
             part->move(getPosition());
-            if (Collisions::pixelPerfectTest(entity, *part))
-            {
-                // Restore original Part's position
-                part->setPosition(relative_pos);
-                entity.collides(*part);
-                break;
-            }
+            bool hit = Collisions::sweptTest(sprite, motion, *part, getMotion());
+            // Restore original Part's position
             part->setPosition(relative_pos);
+            if (hit)
+                return &*part;
         }
     }
-}
-
-
-void MultiPartEntity::updateParts(float frametime)
-{
-    for (size_t i = 0; i < m_parts.size(); ++i)
-    {
-        m_parts[i].onUpdate(frametime);
-    }
+    return NULL;
 }
 
 
@@ -106,7 +106,7 @@ void MultiPartEntity::draw(sf::RenderTarget& target, sf::RenderStates states) co
     for (const Part& part: m_parts)
     {
         if (part.getHP() > 0)
-            target.draw(part, states);
+            part.drawWithFlash(target, states);
     }
 }
 
@@ -121,9 +121,9 @@ MultiPartEntity::Part::Part(int id, int hp):
 }
 
 
-void MultiPartEntity::Part::onUpdate(float frametime)
+void MultiPartEntity::Part::onUpdate(float)
 {
-    updateDamageFlash(frametime);
+    // Parts are moved and animated by their parent entity
 }
 
 
@@ -36,7 +36,7 @@ public:
 
     MultiPartEntity();
 
-    void collides(Entity& entity);
+    Damageable* hitTest(const sf::Sprite& sprite, const sf::Vector2f& motion) override;
 
     // callbacks ---------------------------------------------------------------
 
@@ -46,8 +46,6 @@ public:
     float getSpeedX() const override; // hack for decors
 
 protected:
-    void updateParts(float frametime);
-
     void addPart(Part& part, float x=0.f, float y=0.f);
 
     Part& getPartAt(size_t index);
@@ -67,6 +65,14 @@ protected:
     void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
 
 private:
+    friend class CollisionResponse;
+
+    /**
+     * Find the part hit by a sprite
+     * @return part hit, or NULL
+     */
+    Part* hitPart(const sf::Sprite& sprite, const sf::Vector2f& motion);
+
     typedef std::vector<Part> PartVector;
     PartVector m_parts;
 };
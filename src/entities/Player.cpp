@@ -8,6 +8,7 @@
 #include "items/ItemManager.hpp"
 #include "utils/I18n.hpp"
 #include "utils/Math.hpp"
+#include "utils/StringUtils.hpp"
 
 #define BONUS_SPEED_FACTOR 1.5
 
@@ -18,10 +19,18 @@
 const int MAX_MISSILES = 5;
 const int MAX_ICECUBES = 5;
 
+// Events of the player animation state machine (see animations.xml)
+static constexpr uint32_t EVENT_UP            = utils::hash("up");
+static constexpr uint32_t EVENT_DOWN          = utils::hash("down");
+static constexpr uint32_t EVENT_UP_RELEASED   = utils::hash("up-released");
+static constexpr uint32_t EVENT_DOWN_RELEASED = utils::hash("down-released");
+static constexpr uint32_t EVENT_DESTROYED     = utils::hash("destroyed");
+
 
 Player::Player():
     m_panel(ControlPanel::getInstance()),
     m_overheat(false),
+    m_invulnerable(false),
     m_heat(0.f),
     m_max_heat(0.f),
     m_shield(0),
@@ -30,17 +39,14 @@ Player::Player():
     m_speed(0.f),
     m_missiles(0),
     m_icecubes(0),
-    // Preload animations
-    m_animation_up(EntityManager::getInstance().getAnimation("player-up")),
-    m_animation_down(EntityManager::getInstance().getAnimation("player-down")),
-    m_animation_normal(EntityManager::getInstance().getAnimation("player")),
     m_score(0)
 {
     setTeam(Entity::GOOD);
+    setTypeID(Entity::PLAYER);
     setHP(1);
 
     // Init sprite texture
-    m_animator.setAnimation(*this, m_animation_normal);
+    m_animation.setMachine(*this, EntityManager::getInstance().getAnimationMachine("player"));
 
     // Init weapons
     int xweapon = 54, yweapon = 24;
@@ -186,10 +192,10 @@ void Player::onActionDown(Action::ID action)
     switch (action)
     {
         case Action::UP:
-            m_animator.setAnimation(*this, m_animation_up);
+            m_animation.trigger(*this, EVENT_UP);
             break;
         case Action::DOWN:
-            m_animator.setAnimation(*this, m_animation_down);
+            m_animation.trigger(*this, EVENT_DOWN);
             break;
         case Action::USE_COOLER:
             if (m_icecubes > 0)
@@ -253,8 +259,10 @@ void Player::onActionUp(Action::ID action)
     switch (action)
     {
         case Action::UP:
+            m_animation.trigger(*this, EVENT_UP_RELEASED);
+            break;
         case Action::DOWN:
-            m_animator.setAnimation(*this, m_animation_normal);
+            m_animation.trigger(*this, EVENT_DOWN_RELEASED);
             break;
         default:
             break;
@@ -352,13 +360,13 @@ void Player::onUpdate(float frametime)
         }
     }
 
-    updateDamageFlash(frametime);
+    m_animation.update(*this, frametime);
 }
 
 
 void Player::takeDamage(int damage)
 {
-    if (damage == 0)
+    if (damage == 0 || m_invulnerable)
         return;
 
     if (m_shield > 0)
@@ -367,14 +375,16 @@ void Player::takeDamage(int damage)
         if (m_shield < 0)
             m_shield = 0;
 
-        SoundSystem::playSound("shield-damage.ogg");
+        static constexpr Resources::Key SHIELD_DAMAGE("shield-damage.ogg");
+        SoundSystem::playSound(SHIELD_DAMAGE);
         m_shieldEmitter.createParticles(m_shield);
         m_panel.setShield(m_shield);
     }
     else
     {
         Damageable::takeDamage(damage);
-        SoundSystem::playSound("ship-damage.ogg");
+        static constexpr Resources::Key SHIP_DAMAGE("ship-damage.ogg");
+        SoundSystem::playSound(SHIP_DAMAGE);
         m_panel.setHP(getHP());
 
         if (getHP() == 1)
@@ -385,6 +395,21 @@ void Player::takeDamage(int damage)
 }
 
 
+void Player::setInvulnerable(bool invulnerable)
+{
+    m_invulnerable = invulnerable;
+}
+
+
+void Player::restoreHP(int hp)
+{
+    setHP(hp);
+    m_panel.setHP(hp);
+    if (hp > 1)
+        m_smokeEmitter.clearParticles();
+}
+
+
 void Player::onCollision(PowerUp& powerup)
 {
     switch (powerup.getType())
@@ -467,8 +492,8 @@ void Player::onCollision(PowerUp& powerup)
 
 void Player::onDestroy()
 {
-    setColor(sf::Color::White); // clear red flash
-    m_animator.setAnimation(*this, EntityManager::getInstance().getAnimation("player-destroyed"));
+    clearDamageFlash();
+    m_animation.trigger(*this, EVENT_DESTROYED);
 }
 
 
@@ -2,7 +2,7 @@
 #define PLAYER_HPP
 
 #include "Damageable.hpp"
-#include "Animator.hpp"
+#include "AnimationController.hpp"
 #include "PowerUp.hpp"
 #include "core/Input.hpp"
 #include "core/ControlPanel.hpp"
@@ -30,8 +30,26 @@ public:
 
     void takeDamage(int damage) override;
 
+    /**
+     * Ignore damage, while skipped seconds of a level are simulated (see EntityManager::seek)
+     */
+    void setInvulnerable(bool invulnerable);
+
+    /**
+     * Set hit points and update the control panel
+     */
+    void restoreHP(int hp);
+
     inline bool isCheater() const { return m_konami_code_activated; }
 
+    inline bool isOverheated() const { return m_overheat; }
+
+    inline int getMissileCount() const { return m_missiles; }
+
+    inline int getIcecubeCount() const { return m_icecubes; }
+
+    inline float getSpeed() const { return m_speed; }
+
     // callbacks ---------------------------------------------------------------
 
     void onInit();
@@ -91,6 +109,7 @@ private:
 
     float bonus_[TIMED_BONUS_COUNT]; // timers des bonus
     bool   m_overheat;
+    bool   m_invulnerable;
     float  m_heat, m_max_heat;
     int    m_shield, m_max_shield;
     int    m_max_hp;
@@ -100,10 +119,7 @@ private:
     Weapon m_weapon;
     Weapon m_missile_launcher;
 
-    Animator         m_animator;
-    const Animation& m_animation_up;
-    const Animation& m_animation_down;
-    const Animation& m_animation_normal;
+    AnimationController m_animation;
 
     int              m_score;
 
@@ -8,20 +8,15 @@
 PowerUp::PowerUp(Type type):
     m_type(type)
 {
+    setTypeID(Entity::POWERUP);
     setTexture(Resources::getTexture("entities/power-ups.png"));
     setTextureRect(getTextureRect(type));
 }
 
 
-void PowerUp::collides(Entity& entity)
-{
-    entity.onCollision(*this);
-}
-
-
 void PowerUp::dropRandom(const sf::Vector2f& position)
 {
-    PowerUp* powerup = new PowerUp((Type) math::rand(0, PowerUp::_COUNT - 1));
+    PowerUp* powerup = new PowerUp((Type) math::rand(0, PowerUp::_COUNT - 1, math::DROPS));
     powerup->setPosition(position);
     EntityManager::getInstance().addEntity(powerup);
 }
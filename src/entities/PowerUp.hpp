@@ -25,7 +25,6 @@ public:
 
     PowerUp(Type type);
 
-    void collides(Entity& entity);
 
     /**
      * Drop a random powerup at a given position
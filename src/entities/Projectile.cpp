@@ -8,6 +8,7 @@ Projectile::Projectile(Entity* emitter, float angle, const sf::Texture& image, i
 {
     setTexture(image);
     setTeam(emitter->getTeam());
+    setTypeID(Entity::PROJECTILE);
     setRotation(-math::to_degrees(angle));
 
     // Compute constant speed vector from velocity and angle
@@ -19,19 +20,20 @@ Projectile::Projectile(Entity* emitter, float angle, const sf::Texture& image, i
 }
 
 
-void Projectile::collides(Entity& entity)
+int Projectile::getDamage() const
 {
-    entity.onCollision(*this);
+    return m_damage;
 }
 
 
-int Projectile::getDamage() const
+void Projectile::onUpdate(float frametime)
 {
-    return m_damage;
+    m_motion = m_speed * frametime;
+    move(m_motion);
 }
 
 
-void Projectile::onUpdate(float frametime)
+sf::Vector2f Projectile::getMotion() const
 {
-    move(m_speed.x * frametime, m_speed.y * frametime);
+    return m_motion;
 }
@@ -4,7 +4,9 @@
 #include "Entity.hpp"
 
 /**
- * Bullet entity, see Weapon class
+ * Projectile entity, see Weapon class
+ * Lasers fired with Weapon::shoot<Projectile> are managed by the ProjectileSystem,
+ * this class is the base class for projectiles with their own behavior (Missile).
  */
 class Projectile: public Entity
 {
@@ -18,7 +20,6 @@ public:
      */
     Projectile(Entity* emitter, float angle, const sf::Texture& texture, int speed, int damage);
 
-    void collides(Entity& entity);
 
     int getDamage() const;
 
@@ -26,8 +27,11 @@ public:
 
     void onUpdate(float frametime);
 
+    sf::Vector2f getMotion() const override;
+
 private:
     sf::Vector2f m_speed;
+    sf::Vector2f m_motion; // Displacement during the last update
     int          m_damage;
 };
 
@@ -0,0 +1,192 @@
+#include <algorithm>
+#include <cmath>
+#include "ProjectileSystem.hpp"
+#include "Damageable.hpp"
+#include "EntityManager.hpp"
+#include "core/Collisions.hpp"
+
+
+ProjectileSystem::ProjectileSystem()
+{
+}
+
+
+void ProjectileSystem::add(const Entity& emitter, const sf::Vector2f& position, float angle, const sf::Texture& texture, int speed, int damage)
+{
+    // Find the style matching the texture, there are only a few laser textures
+    size_t style = 0;
+    while (style < m_style_table.size() && m_style_table[style].texture != &texture)
+        ++style;
+
+    if (style == m_style_table.size())
+    {
+        Style new_style;
+        new_style.texture = &texture;
+        new_style.half_size = sf::Vector2f(texture.getSize()) / 2.f;
+        m_style_table.push_back(new_style);
+        m_batches.push_back(sf::VertexArray(sf::Quads));
+        Collisions::registerTexture(&texture);
+    }
+
+    sf::Vector2f axis(std::cos(angle), -std::sin(angle));
+    m_positions.push_back(position);
+    m_speeds.push_back(sf::Vector2f(axis.x * speed + emitter.getSpeedX(), axis.y * speed)); // hack....
+    m_axes.push_back(axis);
+    m_damages.push_back(damage);
+    m_teams.push_back(emitter.getTeam());
+    m_styles.push_back(style);
+}
+
+
+void ProjectileSystem::update(float frametime, const std::list<Entity*>& entities, float width, float height)
+{
+    // Move lasers, and remove those outside the universe
+    for (size_t i = 0; i < m_positions.size();)
+    {
+        sf::Vector2f& position = m_positions[i];
+        position += m_speeds[i] * frametime;
+        const sf::Vector2f& half_size = m_style_table[m_styles[i]].half_size;
+        if (position.x + half_size.x < 0 || position.y + half_size.y < 0 || position.x - half_size.x > width || position.y - half_size.y > height)
+            remove(i);
+        else
+            ++i;
+    }
+
+    // Bounding boxes of the entities are computed once for all lasers
+    m_targets.clear();
+    for (Entity* entity: entities)
+    {
+        if (!entity->isDead())
+        {
+            Target target;
+            target.entity = entity;
+            target.box = entity->getBoundingBox();
+            m_targets.push_back(target);
+        }
+    }
+
+    for (size_t i = 0; i < m_positions.size();)
+    {
+        // Box covering the laser trajectory during this frame
+        const Style& style = m_style_table[m_styles[i]];
+        const sf::Vector2f motion = m_speeds[i] * frametime;
+        const sf::Vector2f end = m_positions[i] - style.half_size;
+        const sf::Vector2f start = end - motion;
+        const sf::FloatRect swept(
+            std::min(start.x, end.x), std::min(start.y, end.y),
+            std::abs(motion.x) + style.half_size.x * 2, std::abs(motion.y) + style.half_size.y * 2
+        );
+
+        bool hit = false;
+        for (const Target& target: m_targets)
+        {
+            if (!swept.intersects(target.box) || target.entity->isDead())
+                continue;
+
+            sf::Sprite probe(*style.texture);
+            probe.setOrigin(style.half_size);
+            probe.setPosition(m_positions[i]);
+            Damageable* damageable = target.entity->hitTest(probe, motion);
+            // Ignore friendly fire
+            if (damageable != NULL && damageable->getTeam() != m_teams[i] && damageable->getHP() > 0)
+            {
+                damageable->takeDamage(m_damages[i]);
+                EntityManager::getInstance().createImpactParticles(m_positions[i], 10);
+                hit = true;
+                break;
+            }
+        }
+
+        if (hit)
+            remove(i);
+        else
+            ++i;
+    }
+}
+
+
+void ProjectileSystem::clear()
+{
+    m_positions.clear();
+    m_speeds.clear();
+    m_axes.clear();
+    m_damages.clear();
+    m_teams.clear();
+    m_styles.clear();
+}
+
+
+size_t ProjectileSystem::getCount() const
+{
+    return m_positions.size();
+}
+
+
+sf::FloatRect ProjectileSystem::getBoundingBox(size_t index) const
+{
+    const sf::Vector2f& half_size = m_style_table[m_styles[index]].half_size;
+    return sf::FloatRect(m_positions[index] - half_size, half_size * 2.f);
+}
+
+
+const sf::Vector2f& ProjectileSystem::getSpeed(size_t index) const
+{
+    return m_speeds[index];
+}
+
+
+Entity::Team ProjectileSystem::getTeam(size_t index) const
+{
+    return static_cast<Entity::Team>(m_teams[index]);
+}
+
+
+void ProjectileSystem::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+    for (sf::VertexArray& batch: m_batches)
+        batch.clear();
+
+    for (size_t i = 0; i < m_positions.size(); ++i)
+    {
+        const Style& style = m_style_table[m_styles[i]];
+        sf::VertexArray& batch = m_batches[m_styles[i]];
+
+        // Rotate the quad along the firing angle
+        const sf::Vector2f& center = m_positions[i];
+        const sf::Vector2f x = m_axes[i] * style.half_size.x;
+        const sf::Vector2f y = sf::Vector2f(-m_axes[i].y, m_axes[i].x) * style.half_size.y;
+        const sf::Vector2f size = style.half_size * 2.f;
+        batch.append(sf::Vertex(center - x - y, sf::Vector2f(0, 0)));
+        batch.append(sf::Vertex(center + x - y, sf::Vector2f(size.x, 0)));
+        batch.append(sf::Vertex(center + x + y, size));
+        batch.append(sf::Vertex(center - x + y, sf::Vector2f(0, size.y)));
+    }
+
+    for (size_t i = 0; i < m_batches.size(); ++i)
+    {
+        if (m_batches[i].getVertexCount() > 0)
+        {
+            states.texture = m_style_table[i].texture;
+            target.draw(m_batches[i], states);
+        }
+    }
+}
+
+
+void ProjectileSystem::remove(size_t index)
+{
+    const size_t last = m_positions.size() - 1;
+    m_positions[index] = m_positions[last];
+    m_speeds[index] = m_speeds[last];
+    m_axes[index] = m_axes[last];
+    m_damages[index] = m_damages[last];
+    m_teams[index] = m_teams[last];
+    m_styles[index] = m_styles[last];
+
+    m_positions.pop_back();
+    m_speeds.pop_back();
+    m_axes.pop_back();
+    m_damages.pop_back();
+    m_teams.pop_back();
+    m_styles.pop_back();
+}
@@ -0,0 +1,89 @@
+#ifndef PROJECTILESYSTEM_HPP
+#define PROJECTILESYSTEM_HPP
+
+#include <cstdint>
+#include <list>
+#include <vector>
+#include <SFML/Graphics.hpp>
+#include "Entity.hpp"
+
+/**
+ * Manager for the lasers fired by weapons (see Weapon::shoot)
+ * Lasers aren't entities: their attributes are stored in flat arrays, updated and
+ * tested against entities in bulk, and drawn with one vertex array per texture.
+ */
+class ProjectileSystem: public sf::Drawable
+{
+public:
+    ProjectileSystem();
+
+    /**
+     * Fire a laser
+     * @param emitter: entity which fired the laser (laser has the same team)
+     * @param position: position of the laser center
+     * @param angle: trajectory angle (radians)
+     * @param texture: texture displayed
+     * @param speed: velocity (pixels / second)
+     * @param damage: inflicted damage if entity is damageable
+     */
+    void add(const Entity& emitter, const sf::Vector2f& position, float angle, const sf::Texture& texture, int speed, int damage);
+
+    /**
+     * Move lasers, remove lasers outside the universe, and damage entities hit by a laser
+     * @param entities: entities which can be hit
+     * @param width: universe width
+     * @param height: universe height
+     */
+    void update(float frametime, const std::list<Entity*>& entities, float width, float height);
+
+    /**
+     * Remove all lasers
+     */
+    void clear();
+
+    /**
+     * Number of lasers
+     */
+    size_t getCount() const;
+
+    sf::FloatRect getBoundingBox(size_t index) const;
+
+    const sf::Vector2f& getSpeed(size_t index) const;
+
+    Entity::Team getTeam(size_t index) const;
+
+private:
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+    /**
+     * Remove a laser, by replacing it with the last one
+     */
+    void remove(size_t index);
+
+    struct Style
+    {
+        const sf::Texture* texture;
+        sf::Vector2f       half_size;
+    };
+
+    struct Target
+    {
+        Entity*       entity;
+        sf::FloatRect box;
+    };
+
+    // Laser attributes, indexed by laser
+    std::vector<sf::Vector2f> m_positions; // Center position
+    std::vector<sf::Vector2f> m_speeds;
+    std::vector<sf::Vector2f> m_axes;      // Unit vector of the firing angle, for rendering
+    std::vector<int>          m_damages;
+    std::vector<uint8_t>      m_teams;
+    std::vector<uint8_t>      m_styles;    // Index in m_style_table
+
+    std::vector<Style>  m_style_table; // One style per texture
+    std::vector<Target> m_targets;     // Entities tested in the current update
+
+    mutable std::vector<sf::VertexArray> m_batches; // Vertices of each style
+};
+
+#endif // PROJECTILESYSTEM_HPP
@@ -1,3 +1,6 @@
+#include <cstring>
+#include <memory>
+#include <vector>
 #include "Spaceship.hpp"
 #include "EntityManager.hpp"
 #include "Player.hpp"
@@ -17,20 +20,70 @@
 #define CIRCLE_RADIUS   60
 #define CIRCLE_ROTATION_SPEED (math::PI * 0.8)
 
-Spaceship::Spaceship(const Animation& animation, int hp, int speed):
-    m_attack(NONE),
-    m_movement(LINE),
-    m_points(1),
+
+bool Spaceship::parseMovementPattern(const char* name, MovementPattern& movement)
+{
+    if (name == NULL)
+        return false;
+
+    if      (strcmp(name, "line")   == 0) movement = LINE;
+    else if (strcmp(name, "magnet") == 0) movement = MAGNET;
+    else if (strcmp(name, "sinus")  == 0) movement = SINUS;
+    else if (strcmp(name, "circle") == 0) movement = CIRCLE;
+    else return false;
+    return true;
+}
+
+
+bool Spaceship::parseAttackPattern(const char* name, AttackPattern& attack)
+{
+    if (name == NULL)
+        return false;
+
+    if      (strcmp(name, "auto_aim") == 0) attack = AUTO_AIM;
+    else if (strcmp(name, "on_sight") == 0) attack = ON_SIGHT;
+    else if (strcmp(name, "none")     == 0) attack = NONE;
+    else return false;
+    return true;
+}
+
+// Spaceships allocated at once when the pool is empty
+#define POOL_BLOCK_SIZE 64
+
+namespace {
+
+// Free slots in allocated blocks, blocks are never released
+std::vector<void*> pool_free_slots;
+std::vector<std::unique_ptr<char[]>> pool_blocks;
+
+}
+
+
+Spaceship::Profile::Profile():
+    animation(NULL),
+    hp(1),
+    speed(0),
+    points(1),
+    movement(LINE),
+    attack(NONE),
+    engine_effect(false)
+{
+}
+
+
+Spaceship::Spaceship(const Profile& profile):
+    m_profile(profile),
+    m_attack(profile.attack),
+    m_movement(profile.movement),
+    m_weapon(profile.weapon),
     m_target(NULL),
-    m_speed(speed),
     m_origin_y(0.f),
-    m_angle(0.f),
-    m_engineEmitterEnabled(false)
+    m_angle(0.f)
 {
-    setTexture(animation.getTexture());
+    setTexture(profile.animation->getTexture());
     setTeam(Entity::BAD);
-    setHP(hp);
-    m_animator.setAnimation(*this, animation);
+    setHP(profile.hp);
+    m_animator.setAnimation(*this, *profile.animation);
 
     m_weapon.setOwner(this);
 }
@@ -41,6 +94,35 @@ Spaceship::~Spaceship()
 }
 
 
+void* Spaceship::operator new(size_t size)
+{
+    if (size != sizeof (Spaceship))
+        return ::operator new(size);
+
+    if (pool_free_slots.empty())
+    {
+        // Slots are aligned on the spaceship alignment
+        const size_t slot_size = (sizeof (Spaceship) + alignof (Spaceship) - 1) / alignof (Spaceship) * alignof (Spaceship);
+        char* block = new char[slot_size * POOL_BLOCK_SIZE];
+        pool_blocks.emplace_back(block);
+        for (int i = POOL_BLOCK_SIZE - 1; i >= 0; --i)
+            pool_free_slots.push_back(block + i * slot_size);
+    }
+    void* slot = pool_free_slots.back();
+    pool_free_slots.pop_back();
+    return slot;
+}
+
+
+void Spaceship::operator delete(void* ptr, size_t size)
+{
+    if (size != sizeof (Spaceship))
+        ::operator delete(ptr);
+    else if (ptr != NULL)
+        pool_free_slots.push_back(ptr);
+}
+
+
 void Spaceship::onInit()
 {
     if (m_movement == SINUS)
@@ -74,7 +156,7 @@ void Spaceship::onInit()
 
     m_target = EntityManager::getInstance().getPlayer();
 
-    if (m_engineEmitterEnabled)
+    if (m_profile.engine_effect)
     {
         m_engineEmitter.setTextureRect({32, 9, 3, 3});
         m_engineEmitter.setAngle(math::PI * 2, 0.1);
@@ -100,21 +182,12 @@ void Spaceship::setAttackPattern(AttackPattern attack)
 }
 
 
-Spaceship* Spaceship::clone() const
-{
-    Spaceship* ship = new Spaceship(*this);
-    ship->setPoints(getPoints()); // ???
-    ship->m_weapon.setOwner(ship);
-    return ship;
-}
-
-
 void Spaceship::onUpdate(float frametime)
 {
-    m_animator.updateSubRect(*this, frametime);
+    m_animator.updateSubRect(*this);
 
     // Apply movement pattern
-    float delta = m_speed * frametime;
+    float delta = m_profile.speed * frametime;
     switch (m_movement)
     {
         case LINE:
@@ -166,11 +239,9 @@ void Spaceship::onUpdate(float frametime)
             break;
     }
 
-    updateDamageFlash(frametime);
-
-    if (m_engineEmitterEnabled)
+    if (m_profile.engine_effect)
     {
-        m_engineEmitter.setPosition(getPosition() + m_engineOffset);
+        m_engineEmitter.setPosition(getPosition() + m_profile.engine_offset);
     }
 }
 
@@ -178,13 +249,13 @@ void Spaceship::onUpdate(float frametime)
 void Spaceship::onDestroy()
 {
     Damageable::onDestroy();
-    if (math::rand(1, DROP_LUCK) == 1)
+    if (math::rand(1, DROP_LUCK, math::DROPS) == 1)
     {
         PowerUp::dropRandom(getPosition());
     }
 
-    EntityManager::getInstance().getPlayer()->updateScore(m_points);
-    MessageSystem::write("+" + std::to_string(m_points), getPosition(), sf::Color(255, 128, 0));
+    EntityManager::getInstance().getPlayer()->updateScore(m_profile.points);
+    MessageSystem::write("+" + std::to_string(m_profile.points), getPosition(), sf::Color(255, 128, 0));
 }
 
 
@@ -194,20 +265,7 @@ Weapon& Spaceship::getWeapon()
 }
 
 
-void Spaceship::enableEngineEffect(const sf::Vector2f& offset)
-{
-    m_engineEmitterEnabled = true;
-    m_engineOffset = offset;
-}
-
-
-void Spaceship::setPoints(int points)
-{
-    m_points = points;
-}
-
-
 int Spaceship::getPoints() const
 {
-    return m_points;
+    return m_profile.points;
 }
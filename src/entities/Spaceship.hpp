@@ -19,24 +19,56 @@ public:
         AUTO_AIM, ON_SIGHT, NONE
     };
 
-    Spaceship(const Animation& animation, int hp, int speed);
-    ~Spaceship();
+    /**
+     * Get a movement pattern from its name in XML documents ("magnet", "line", "sinus", "circle")
+     * @return false if name is NULL or unknown
+     */
+    static bool parseMovementPattern(const char* name, MovementPattern& movement);
 
-    void setMovementPattern(MovementPattern movement);
+    /**
+     * Get an attack pattern from its name in XML documents ("auto_aim", "on_sight", "none")
+     * @return false if name is NULL or unknown
+     */
+    static bool parseAttackPattern(const char* name, AttackPattern& attack);
 
-    void setAttackPattern(AttackPattern attack);
+    /**
+     * Attributes shared by all spaceships of a kind, loaded from XML document
+     * (see EntityManager::loadSpaceships)
+     */
+    struct Profile
+    {
+        Profile();
+
+        const Animation* animation;
+        int              hp;
+        int              speed;
+        int              points;
+        MovementPattern  movement;
+        AttackPattern    attack;
+        Weapon           weapon;        // Weapon attributes and position, without owner
+        bool             engine_effect; // Enable engine particle effect
+        sf::Vector2f     engine_offset; // Particle emitter origin, relative to spaceship position
+    };
 
-    Spaceship* clone() const;
+    /**
+     * @param profile: must outlive the spaceship
+     */
+    Spaceship(const Profile& profile);
+    ~Spaceship();
 
-    Weapon& getWeapon();
+    // Spaceships are allocated from a pool
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr, size_t size);
 
     /**
-     * Enable engine particle effect
-     * @param offset: particle emitter origin, relative to spaceship position
+     * Override the profile patterns
      */
-    void enableEngineEffect(const sf::Vector2f& offset);
+    void setMovementPattern(MovementPattern movement);
+
+    void setAttackPattern(AttackPattern attack);
+
+    Weapon& getWeapon();
 
-    void setPoints(int points);
     int getPoints() const;
 
     // callbacks ---------------------------------------------------------------
@@ -46,21 +78,20 @@ public:
     void onDestroy() override;
 
 private:
+    Spaceship(const Spaceship&);
+
+    const Profile&  m_profile;
     AttackPattern   m_attack;
     MovementPattern m_movement;
 
-    int       m_points;
     Weapon    m_weapon;
     Entity*   m_target;
     Animator  m_animator;
 
-    int       m_speed;
     float     m_origin_y;
     float     m_angle;
 
-    bool m_engineEmitterEnabled;
     ParticleEmitter m_engineEmitter;
-    sf::Vector2f m_engineOffset;
 };
 
 #endif // SPACESHIP_HPP
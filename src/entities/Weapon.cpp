@@ -1,3 +1,4 @@
+#include <limits>
 #include "Weapon.hpp"
 #include "EntityManager.hpp"
 
@@ -10,6 +11,7 @@ Weapon::Weapon():
     m_texture(NULL),
     m_sound(NULL),
     m_owner(NULL),
+    m_last_shot_at(-std::numeric_limits<float>::infinity()),
     m_multiply(1)
 {
 }
@@ -79,7 +81,9 @@ void Weapon::setOwner(Entity* owner)
 
 bool Weapon::isReady() const
 {
-    return m_last_shot_at.getElapsedTime().asSeconds() >= m_fire_delay;
+    // Game time is reset when a level starts
+    float elapsed = getTime() - m_last_shot_at;
+    return elapsed >= m_fire_delay || elapsed < 0.f;
 }
 
 
@@ -89,9 +93,21 @@ void Weapon::setMultiply(int n)
 }
 
 
+float Weapon::getTime()
+{
+    return EntityManager::getInstance().getTimer();
+}
+
+
 void Weapon::insert(const sf::Vector2f& pos, Entity* projectile)
 {
     projectile->setPosition(pos);
     EntityManager::getInstance().addEntity(projectile);
 }
 
+
+void Weapon::insertLaser(const sf::Vector2f& pos, float angle)
+{
+    EntityManager::getInstance().getProjectiles().add(*m_owner, pos, angle, *m_texture, m_velocity, m_damage);
+}
+
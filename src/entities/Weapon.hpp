@@ -83,6 +83,11 @@ public:
      */
     bool isReady() const;
 
+    /**
+     * true if weapon attributes were initialized (see init)
+     */
+    inline bool isInitialized() const { return m_texture != NULL; }
+
     void setMultiply(int n);
 
 protected:
@@ -92,6 +97,16 @@ protected:
 private:
     void insert(const sf::Vector2f& pos, Entity* entity);
 
+    /**
+     * Add a laser to the projectile system
+     */
+    void insertLaser(const sf::Vector2f& pos, float angle);
+
+    /**
+     * Elapsed game time in the current level, in seconds
+     */
+    static float getTime();
+
     // Weapon-type attributes
     float                  m_fire_delay;   // Time to wait between next shot
     float                  m_heat_cost;
@@ -102,7 +117,7 @@ private:
 
     // Weapon usage
     Entity*      m_owner;
-    sf::Clock    m_last_shot_at; // Store time for last shot
+    float        m_last_shot_at; // Game time of the last shot
     sf::Vector2f m_position;
     int          m_multiply;
 };
@@ -116,7 +131,7 @@ float Weapon::shoot(float angle)
 
 
     // If ready for next round
-    if (m_last_shot_at.getElapsedTime().asSeconds() >= m_fire_delay)
+    if (isReady())
     {
         sf::Vector2f pos = m_owner->getPosition() + m_position;
 
@@ -142,7 +157,7 @@ float Weapon::shoot(float angle)
         {
             SoundSystem::playSound(*m_sound);
         }
-        m_last_shot_at.restart();
+        m_last_shot_at = getTime();
         return m_heat_cost;
     }
     return 0.f;
@@ -162,5 +177,12 @@ void Weapon::createProjectile(const sf::Vector2f& position, float angle)
     insert(position, projectile);
 }
 
+// Lasers are managed by the projectile system, other projectiles are entities
+template <>
+inline void Weapon::createProjectile<Projectile>(const sf::Vector2f& position, float angle)
+{
+    insertLaser(position, angle);
+}
+
 
 #endif // WEAPON_HPP
@@ -34,8 +34,7 @@ BrainBoss::BrainBoss():
 
 void BrainBoss::onUpdate(float frametime)
 {
-    updateParts(frametime);
-    m_animator.updateSubRect(getPartAt(0), frametime);
+    m_animator.updateSubRect(getPartAt(0));
     m_state_timer += frametime;
     switch (m_state)
     {
@@ -65,7 +64,7 @@ void BrainBoss::onUpdate(float frametime)
             }
             else
             {
-                m_eye_animator.updateSubRect(getPartAt(1), frametime);
+                m_eye_animator.updateSubRect(getPartAt(1));
             }
             break;
         }
@@ -56,8 +56,6 @@ void EvilBoss::onUpdate(float frametime)
     {
         move(m_speed.x * frametime, 0);
     }
-
-    updateDamageFlash(frametime);
 }
 
 
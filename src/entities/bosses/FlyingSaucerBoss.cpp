@@ -14,6 +14,7 @@
 
 FlyingSaucerBoss::FlyingSaucerBoss():
     m_target(NULL),
+    m_mob_profile(EntityManager::getInstance().getSpaceshipProfileID("s1")),
     m_timer(0),
     m_angle(0)
 {
@@ -51,14 +52,13 @@ void FlyingSaucerBoss::onUpdate(float frametime)
         pos.y -= CIRCLE_RADIUS * std::sin(m_angle);
         setPosition(pos);
     }
-    updateDamageFlash(frametime);
 
     m_timer += frametime;
-    if (m_timer > 5.f)
+    if (m_timer > 5.f && m_mob_profile != -1)
     {
         m_timer = 0.f;
         EntityManager& em = EntityManager::getInstance();
-        Spaceship* mob = em.createSpaceship("s1");
+        Spaceship* mob = em.createSpaceship(m_mob_profile);
         mob->setPosition(getCenter());
         em.addEntity(mob);
     }
@@ -18,6 +18,7 @@ public:
 
 private:
     Entity* m_target;
+    int   m_mob_profile; // Profile ID of the spawned spaceships
     float m_timer;
     float m_angle;
     Weapon m_left_tube;
@@ -34,7 +34,7 @@ void TentaculatBoss::onInit()
 
 void TentaculatBoss::onUpdate(float frametime)
 {
-    m_animator.updateSubRect(*this, frametime);
+    m_animator.updateSubRect(*this);
 
     m_timer += frametime;
 
@@ -95,7 +95,6 @@ void TentaculatBoss::onUpdate(float frametime)
             break;
     }
     move(m_speed.x * frametime, m_speed.y * frametime);
-    updateDamageFlash(frametime);
 }
 
 
@@ -32,7 +32,6 @@ void Canon::onInit()
 void Canon::onUpdate(float frametime)
 {
     move(-EntityManager::FOREGROUND_SPEED * frametime, 0.f);
-    updateParts(frametime);
 
     m_weapon.shoot(math::PI / 2.f);
 }
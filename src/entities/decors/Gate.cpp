@@ -42,9 +42,8 @@ Gate::Gate():
 void Gate::onUpdate(float frametime)
 {
     move(-EntityManager::FOREGROUND_SPEED * frametime, 0.f);
-    m_cell_animator1.updateSubRect(getPartAt(0), frametime);
-    m_cell_animator2.updateSubRect(getPartAt(4), frametime);
-    updateParts(frametime);
+    m_cell_animator1.updateSubRect(getPartAt(0));
+    m_cell_animator2.updateSubRect(getPartAt(4));
 
     if (m_door_timer > 0)
     {
@@ -33,7 +33,6 @@ GunTower::GunTower():
 void GunTower::onUpdate(float frametime)
 {
     move(-EntityManager::FOREGROUND_SPEED * frametime, 0.f);
-    updateParts(frametime);
 
     // Rotate turret toward player
     Part& turret = getPartAt(0);
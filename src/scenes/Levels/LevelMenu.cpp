@@ -2,7 +2,6 @@
 #include "core/Game.hpp"
 #include "core/UserSettings.hpp"
 #include "core/LevelManager.hpp"
-#include "core/ControlPanel.hpp"
 #include "utils/I18n.hpp"
 
 
@@ -24,24 +23,7 @@ LevelMenu::LevelMenu():
     gui::VBoxLayout layout(210, 240);
     // Play selected level
     layout.Add(new CosmoButton(this, _t("levels.play")))->setCallback([this]() {
-        int selected_level = m_opt_levels->GetSelectedValue();
-        // Load selected level in the level manager
-        m_levels.setCurrent(selected_level);
-        m_levels.initCurrentLevel();
-
-#ifdef DEBUG
-        printf("level %u (music: %s)\n", selected_level, m_levels.getMusicName());
-        printf(" - available points: %d\n", m_levels.getTotalPoints());
-        printf(" - entities:         %d\n", m_levels.getSpawnQueueSize());
-        printf(" - duration:      %02d:%02d\n", (int) m_levels.getDuration() / 60, (int) m_levels.getDuration() % 60);
-#endif
-        // Init control panel
-        ControlPanel::getInstance().setGameInfo(
-            I18n::templatize("panel.level", "{level}", selected_level)
-        );
-        // Init entity manager
-        EntityManager::getInstance().initialize();
-        Game::getInstance().setCurrentScreen(Game::SC_PlayScreen);
+        Game::getInstance().startLevel(m_opt_levels->GetSelectedValue());
     });
 
     // Go to armory menu
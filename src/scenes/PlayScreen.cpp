@@ -4,6 +4,8 @@
 #include "core/UserSettings.hpp"
 #include "core/Input.hpp"
 #include "core/ControlPanel.hpp"
+#include "core/Replay.hpp"
+#include "core/Autopilot.hpp"
 #include "entities/EntityManager.hpp"
 #include "entities/Player.hpp"
 
@@ -32,7 +34,12 @@ void PlayScreen::onEvent(const sf::Event& event)
             Game::getInstance().setCurrentScreen(Game::SC_PauseMenu);
             break;
         default:
-            m_entities.getPlayer()->onActionDown(action);
+            // Player is driven by the replay when playing back, or by the autopilot
+            if (Replay::getMode() != Replay::PLAYING && !Autopilot::isEnabled())
+            {
+                Replay::recordAction(action, true);
+                m_entities.getPlayer()->onActionDown(action);
+            }
             break;
     }
 
@@ -40,7 +47,12 @@ void PlayScreen::onEvent(const sf::Event& event)
     switch (event.type)
     {
         case sf::Event::KeyReleased:
-            m_entities.getPlayer()->onActionUp(Input::matchKey(event.key.code));
+            if (Replay::getMode() != Replay::PLAYING && !Autopilot::isEnabled())
+            {
+                action = Input::matchKey(event.key.code);
+                Replay::recordAction(action, false);
+                m_entities.getPlayer()->onActionUp(action);
+            }
             break;
         case sf::Event::LostFocus:
             Game::getInstance().setCurrentScreen(Game::SC_PauseMenu);
@@ -62,8 +74,31 @@ void PlayScreen::onFocus()
 
 void PlayScreen::update(float frametime)
 {
+    if (Replay::getMode() == Replay::PLAYING)
+    {
+        // Override frame time and input state with the recorded ones
+        if (!Replay::playFrame(frametime, *m_entities.getPlayer()))
+        {
+            Game::getInstance().quit();
+            return;
+        }
+    }
+    else
+    {
+        if (Autopilot::isEnabled())
+            Autopilot::update(*m_entities.getPlayer(), frametime);
+
+        Replay::recordFrame(frametime);
+    }
+
     if (m_entities.spawnBadGuys())
     {
+        if (Replay::getMode() == Replay::PLAYING)
+        {
+            Game::getInstance().quit();
+            return;
+        }
+        Replay::endLevel();
         Game::getInstance().setCurrentScreen(Game::SC_GameOverScreen);
     }
     else
@@ -49,6 +49,28 @@ bool is_file(const std::string& path)
 }
 
 
+size_t file_size(const std::string& path)
+{
+    struct stat sb;
+    if (stat(path.c_str(), &sb) == 0)
+    {
+        return sb.st_size;
+    }
+    return 0;
+}
+
+
+time_t last_modified(const std::string& path)
+{
+    struct stat sb;
+    if (stat(path.c_str(), &sb) == 0)
+    {
+        return sb.st_mtime;
+    }
+    return 0;
+}
+
+
 bool create_directory(const std::string& name)
 {
     bool success = false;
@@ -1,6 +1,8 @@
 #ifndef FILESYSTEM_HPP
 #define FILESYSTEM_HPP
 
+#include <cstddef>
+#include <ctime>
 #include <string>
 
 /**
@@ -18,6 +20,16 @@ bool is_directory(const std::string& path);
  */
 bool is_file(const std::string& path);
 
+/**
+ * @return size of a file in bytes, 0 if it doesn't exist
+ */
+size_t file_size(const std::string& path);
+
+/**
+ * @return last modification time of a file, 0 if it doesn't exist
+ */
+time_t last_modified(const std::string& path);
+
 /**
  * Create a directory
  * @return true if directory successfully created
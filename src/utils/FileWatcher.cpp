@@ -0,0 +1,99 @@
+#include "FileWatcher.hpp"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <iostream>
+
+#if defined(__linux__)
+    #define SYS_LINUX
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
+
+FileWatcher::FileWatcher():
+    m_fd(-1),
+    m_mtime(0)
+{
+}
+
+
+FileWatcher::~FileWatcher()
+{
+    close();
+}
+
+
+bool FileWatcher::watch(const std::string& path)
+{
+    close();
+    m_path = path;
+    size_t last_separator = path.find_last_of("/\\");
+    std::string directory = last_separator == std::string::npos ? "." : path.substr(0, last_separator + 1);
+    m_filename = last_separator == std::string::npos ? path : path.substr(last_separator + 1);
+
+    struct stat sb;
+    if (stat(path.c_str(), &sb) != 0)
+    {
+        std::cerr << "cannot watch file " << path << std::endl;
+        return false;
+    }
+    m_mtime = sb.st_mtime;
+
+#ifdef SYS_LINUX
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_fd != -1 && inotify_add_watch(m_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) == -1)
+    {
+        // Fall back on modification time
+        std::cerr << "cannot watch directory " << directory << " with inotify" << std::endl;
+        close();
+    }
+#endif
+    return true;
+}
+
+
+bool FileWatcher::hasChanged()
+{
+    if (m_path.empty())
+        return false;
+
+#ifdef SYS_LINUX
+    if (m_fd != -1)
+    {
+        bool changed = false;
+        // Drain all pending events, several events are sent for a single save
+        char buffer[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+        ssize_t length;
+        while ((length = read(m_fd, buffer, sizeof (buffer))) > 0)
+        {
+            for (char* ptr = buffer; ptr < buffer + length;)
+            {
+                const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(ptr);
+                if (event->len > 0 && m_filename == event->name)
+                    changed = true;
+                ptr += sizeof (struct inotify_event) + event->len;
+            }
+        }
+        return changed;
+    }
+#endif
+
+    struct stat sb;
+    if (stat(m_path.c_str(), &sb) == 0 && sb.st_mtime != m_mtime)
+    {
+        m_mtime = sb.st_mtime;
+        return true;
+    }
+    return false;
+}
+
+
+void FileWatcher::close()
+{
+#ifdef SYS_LINUX
+    if (m_fd != -1)
+        ::close(m_fd);
+#endif
+    m_fd = -1;
+}
@@ -0,0 +1,42 @@
+#ifndef FILEWATCHER_HPP
+#define FILEWATCHER_HPP
+
+#include <string>
+#include <ctime>
+
+/**
+ * Watch a file for modifications
+ * Uses inotify on Linux, and the file modification time on other systems.
+ * The parent directory is watched, so files replaced by text editors are detected.
+ */
+class FileWatcher
+{
+public:
+    FileWatcher();
+    ~FileWatcher();
+
+    /**
+     * Start watching a file, stop watching the previous one
+     * @return true if file can be watched
+     */
+    bool watch(const std::string& path);
+
+    /**
+     * Non-blocking check
+     * @return true if file has been modified since the last call
+     */
+    bool hasChanged();
+
+private:
+    FileWatcher(const FileWatcher&);
+    FileWatcher& operator=(const FileWatcher&);
+
+    void close();
+
+    std::string m_path;
+    std::string m_filename; // Name of the file in its directory
+    int         m_fd;       // inotify instance, -1 if not used
+    time_t      m_mtime;    // Last modification time, if inotify isn't used
+};
+
+#endif // FILEWATCHER_HPP
@@ -1,13 +1,30 @@
+#include <algorithm>
 #include <clocale>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <map>
 
 #include "I18n.hpp"
+#include "FileSystem.hpp"
 
 #define TOKEN_SEPARATOR   '='
 #define TOKEN_COMMENT     '#'
 #define DEFAULT_LANG_CODE "en"
 
+#define PACK_MAGIC        "CSLP"
+#define PACK_VERSION      1
+#define PACK_HEADER_SIZE  16
+#define PACK_ENTRY_SIZE   12
+
+
+// Read a little-endian 32 bits integer
+static uint32_t read_u32(const char* p)
+{
+    const unsigned char* b = reinterpret_cast<const unsigned char*>(p);
+    return b[0] | (b[1] << 8) | (b[2] << 16) | (static_cast<uint32_t>(b[3]) << 24);
+}
+
 
 I18n& I18n::getInstance()
 {
@@ -29,16 +46,25 @@ void I18n::setDataPath(const std::string& path)
 }
 
 
-const sf::String& I18n::translate(const std::string& key) const
+const sf::String& I18n::translate(const char* key) const
 {
-    TextMap::const_iterator it = m_content.find(key);
-    if (it == m_content.end())
+    uint32_t hash = utils::hash(key);
+    TextVector::const_iterator it = std::lower_bound(m_content.begin(), m_content.end(), hash,
+        [](const Entry& entry, uint32_t value) { return entry.hash < value; });
+
+    if (it == m_content.end() || it->hash != hash)
     {
         std::cerr << "[I18n] no translation found for key '" << key << "' (" << m_code << ")" << std::endl;
         static sf::String error("text not found");
         return error;
     }
-    return it->second;
+    return it->text;
+}
+
+
+const sf::String& I18n::translate(const std::string& key) const
+{
+    return translate(key.c_str());
 }
 
 
@@ -73,8 +99,11 @@ bool I18n::loadFromCode(const std::string& code)
 {
     if (code.size() == 2 && code[0] >= 'a' && code[0] <= 'z' && code[1] >= 'a' && code[1] <= 'z')
     {
+        // A pack older than its text file is out of date (see 'make lang'), ignore it
         std::string filename = m_path + "/" + code + ".lang";
-        if (loadFromFile(filename.c_str()))
+        std::string pack = filename + "c";
+        bool use_pack = filesystem::last_modified(pack) >= filesystem::last_modified(filename);
+        if ((use_pack && loadFromPack(pack.c_str())) || loadFromFile(filename.c_str()))
         {
             m_code[0] = code[0];
             m_code[1] = code[1];
@@ -95,6 +124,7 @@ bool I18n::loadFromFile(const char* filename)
     if (file)
     {
         m_content.clear();
+        std::map<uint32_t, std::string> keys;
         std::string line;
         int line_number = 0;
         while (std::getline(file, line))
@@ -110,16 +140,86 @@ bool I18n::loadFromFile(const char* filename)
                 std::string key = utils::trim(line.substr(0, pos));
                 std::string content = utils::trim(line.substr(pos + 1));
 
+                // The first definition of a key wins
+                uint32_t hash = utils::hash(key.c_str());
+                std::map<uint32_t, std::string>::const_iterator it = keys.find(hash);
+                if (it != keys.end())
+                {
+                    if (it->second != key)
+                        std::cerr << "[I18n] error at line " << line_number << ": key '" << key
+                                  << "' has the same hash as '" << it->second << "', ignored" << std::endl;
+                    continue;
+                }
+                keys[hash] = key;
+
                 // Decode utf-8 and convert to sf::String
-                m_content.emplace(key, sf::String::fromUtf8(content.begin(), content.end()));
-                m_content.at(key).replace("\\n", "\n");
+                Entry entry;
+                entry.hash = hash;
+                entry.text = sf::String::fromUtf8(content.begin(), content.end());
+                entry.text.replace("\\n", "\n");
+                m_content.push_back(entry);
             }
             else
             {
                 std::cerr << "[I18n] error at line " << line_number << ": " << line << std::endl;
             }
         }
+        // Sort by hash for lookups
+        std::sort(m_content.begin(), m_content.end(),
+            [](const Entry& a, const Entry& b) { return a.hash < b.hash; });
         return true;
     }
     return false;
 }
+
+
+bool I18n::loadFromPack(const char* filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file)
+        return false;
+
+    // Read the whole pack at once
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.size() < PACK_HEADER_SIZE || !std::equal(PACK_MAGIC, PACK_MAGIC + 4, data.begin())
+        || read_u32(&data[4]) != PACK_VERSION)
+    {
+        std::cerr << "[I18n] " << filename << " is not a valid language pack" << std::endl;
+        return false;
+    }
+
+    // Sizes are computed on 64 bits so that a corrupted header cannot overflow them
+    uint64_t count = read_u32(&data[8]);
+    uint64_t blob_size = read_u32(&data[12]);
+    uint64_t blob_start = PACK_HEADER_SIZE + count * PACK_ENTRY_SIZE;
+    if (data.size() != blob_start + blob_size * 4)
+    {
+        std::cerr << "[I18n] language pack " << filename << " is truncated" << std::endl;
+        return false;
+    }
+
+    // Decode UTF-32 blob
+    std::vector<sf::Uint32> blob(blob_size);
+    for (size_t i = 0; i < blob_size; ++i)
+        blob[i] = read_u32(&data[blob_start + i * 4]);
+
+    // Entries must be sorted by hash, without duplicates, for lookups
+    m_content.clear();
+    m_content.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const char* p = &data[PACK_HEADER_SIZE + i * PACK_ENTRY_SIZE];
+        uint32_t hash = read_u32(p);
+        uint32_t offset = read_u32(p + 4);
+        uint32_t length = read_u32(p + 8);
+        if (offset > blob_size || length > blob_size - offset || (i > 0 && hash <= m_content[i - 1].hash))
+        {
+            std::cerr << "[I18n] invalid entry " << i << " in language pack " << filename << std::endl;
+            m_content.clear();
+            return false;
+        }
+        m_content[i].hash = hash;
+        m_content[i].text = sf::String::fromUtf32(blob.begin() + offset, blob.begin() + offset + length);
+    }
+    return true;
+}
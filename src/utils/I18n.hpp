@@ -1,7 +1,7 @@
 #ifndef I18N_HPP
 #define I18N_HPP
 
-#include <map>
+#include <vector>
 #include <string>
 #include <iostream>
 #include <SFML/System/String.hpp>
@@ -26,6 +26,7 @@ public:
      * @param key: text identifier
      * @return translated string
      */
+    const sf::String& translate(const char* key) const;
     const sf::String& translate(const std::string& key) const;
 
     /**
@@ -41,6 +42,8 @@ public:
 
     /**
      * Load the transalation file matching a given language code
+     * The compiled language pack (.langc) is used if available and not older than
+     * the text file (.lang), otherwise the text file is loaded
      * @param code: 2-chars string language code ("en", "fr", "de"...)
      */
     bool loadFromCode(const std::string& code);
@@ -80,8 +83,19 @@ private:
      */
     bool loadFromFile(const char* filename);
 
-    typedef std::map<std::string, sf::String> TextMap;
-    TextMap     m_content;
+    /**
+     * Load a compiled language pack (see tools/compile_lang.py)
+     */
+    bool loadFromPack(const char* filename);
+
+    struct Entry
+    {
+        uint32_t   hash; // Hash of the text identifier
+        sf::String text;
+    };
+
+    typedef std::vector<Entry> TextVector;
+    TextVector  m_content; // Sorted by hash
     char        m_code[3];
     std::string m_path;
 };
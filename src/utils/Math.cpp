@@ -4,11 +4,43 @@
 namespace math
 {
 
+// SplitMix64, used to expand a seed into a generator state
+static uint64_t splitmix64(uint64_t& x)
+{
+    uint64_t z = (x += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+
+Random::Random(uint32_t seed, uint32_t stream)
+{
+    this->seed(seed, stream);
+}
+
+
+void Random::seed(uint32_t seed, uint32_t stream)
+{
+    uint64_t x = (static_cast<uint64_t>(stream) << 32) | seed;
+    uint64_t a = splitmix64(x);
+    uint64_t b = splitmix64(x);
+    m_state[0] = static_cast<uint32_t>(a);
+    m_state[1] = static_cast<uint32_t>(a >> 32);
+    m_state[2] = static_cast<uint32_t>(b);
+    m_state[3] = static_cast<uint32_t>(b >> 32);
+}
+
+static Random streams[STREAM_COUNT];
+
 // Set the random numbers sequence seed with the current system time, so that it is always different
 unsigned int static set_random_seed()
 {
     unsigned int seed = static_cast<unsigned int>(time(NULL));
-    std::srand(seed);
+    for (int i = 0; i < STREAM_COUNT; ++i)
+    {
+        streams[i].seed(seed, i);
+    }
     return seed;
 }
 
@@ -17,21 +49,18 @@ const float PI = 3.14159265f;
 unsigned int seed = set_random_seed();
 
 
-int rand(int begin, int end)
-{
-    return std::rand() % (end - begin + 1) + begin;
-}
-
-
-float rand(float begin, float end)
+Random& random(Stream stream)
 {
-    return static_cast<float>(std::rand()) / RAND_MAX * (end - begin) + begin;
+    return streams[stream];
 }
 
 
 void set_seed(unsigned int s)
 {
-    std::srand(s);
+    for (int i = 0; i < STREAM_COUNT; ++i)
+    {
+        streams[i].seed(s, i);
+    }
     seed = s;
 }
 
@@ -2,7 +2,7 @@
 #define MATH_HPP
 
 #include <cmath>
-#include <cstdlib>
+#include <cstdint>
 
 namespace math
 {
@@ -63,23 +63,110 @@ inline float angle(const Vec& a, const Vec& b = Vec())
 
 // Random ----------------------------------------------------------------------
 
+/**
+ * Pseudo-random number generator (xoshiro128**)
+ * Not thread-safe: each thread must use its own generator.
+ */
+class Random
+{
+public:
+    /**
+     * @param seed: sequence seed
+     * @param stream: generators with the same seed but different streams produce
+     * independent sequences
+     */
+    explicit Random(uint32_t seed = 0, uint32_t stream = 0);
+
+    /**
+     * Reset the sequence
+     */
+    void seed(uint32_t seed, uint32_t stream = 0);
+
+    /**
+     * Get next random 32 bits value
+     */
+    inline uint32_t next()
+    {
+        const uint32_t result = rotl(m_state[1] * 5, 7) * 9;
+        const uint32_t t = m_state[1] << 9;
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = rotl(m_state[3], 11);
+        return result;
+    }
+
+    /**
+     * Get a random int value between begin and end (included)
+     */
+    inline int rand(int begin, int end)
+    {
+        // Map 32 bits to [0, end - begin] without division
+        const uint64_t range = static_cast<uint64_t>(end - begin) + 1;
+        return begin + static_cast<int>((next() * range) >> 32);
+    }
+
+    /**
+     * Get a random float value between begin and end (included)
+     */
+    inline float rand(float begin, float end)
+    {
+        // 24 bits: float mantissa precision
+        return (next() >> 8) * (1.f / 16777215.f) * (end - begin) + begin;
+    }
+
+private:
+    static inline uint32_t rotl(uint32_t x, int k)
+    {
+        return (x << k) | (x >> (32 - k));
+    }
+
+    uint32_t m_state[4];
+};
+
+/**
+ * Random sequences used by the game, all seeded from the same seed
+ * Subsystems draw from separate streams, so the gameplay sequence doesn't depend on
+ * how many particles or drops were generated.
+ */
+enum Stream
+{
+    GAMEPLAY,  // Entities behavior
+    PARTICLES, // Particle effects
+    DROPS,     // Power-ups dropped by enemies
+    STREAM_COUNT
+};
+
 /**
  * Random generator seed, initialized to current timestamp
  */
 extern unsigned int seed;
 
+/**
+ * Get the random generator for a stream
+ */
+Random& random(Stream stream);
+
 /**
  * Get a random int value between begin and end
  */
-int rand(int begin, int end);
+inline int rand(int begin, int end, Stream stream = GAMEPLAY)
+{
+    return random(stream).rand(begin, end);
+}
 
 /**
  * Get a random float value between begin and end
  */
-float rand(float begin, float end);
+inline float rand(float begin, float end, Stream stream = GAMEPLAY)
+{
+    return random(stream).rand(begin, end);
+}
 
 /**
- * Initialize random number generator seed
+ * Initialize random number generator seed, and reset all streams
  */
 void set_seed(unsigned int seed);
 
@@ -1,9 +1,16 @@
+#include <algorithm>
+#include <chrono>
 #include <cstring>
 #include <iostream>
 #include <dumb.h>
 #include "ModMusic.hpp"
 
+// Longest module rendered to the PCM cache, in seconds
+#define PRERENDER_MAX_DURATION 900
+
 ModMusic::Init ModMusic::s_init;
+std::string    ModMusic::s_cache_dir;
+sf::Time       ModMusic::s_buffer_duration = sf::seconds(2.f);
 
 
 ModMusic::Init::Init()
@@ -19,40 +26,91 @@ ModMusic::Init::~Init()
 }
 
 
+static DUH* load_module(const std::string& filename)
+{
+    // Guess file type from extension
+    const char* ext = strrchr(filename.c_str(), '.');
+    if (ext == NULL)
+        return NULL;
+
+    if (strcmp(ext, ".mod") == 0) // Amiga module
+        return dumb_load_mod_quick(filename.c_str());
+
+    if (strcmp(ext, ".xm") == 0) // Fast Tracker II
+        return dumb_load_xm_quick(filename.c_str());
+
+    if (strcmp(ext, ".s3m") == 0) // Scream Tracker 3
+        return dumb_load_s3m_quick(filename.c_str());
+
+    if (strcmp(ext, ".it") == 0) // Impulse Tracker
+        return dumb_load_it_quick(filename.c_str());
+
+    return NULL;
+}
+
+
 ModMusic::ModMusic():
     m_module(NULL),
-    m_player(NULL)
+    m_player(NULL),
+    m_pcm_file(NULL),
+    m_pcm_size(0),
+    m_read_pos(0),
+    m_write_pos(0),
+    m_underruns(0),
+    m_streaming(false),
+    m_prerendering(false)
 {
 }
 
 
 ModMusic::~ModMusic()
 {
+    stop();
     close();
+    stopPrerendering();
 }
 
 
 bool ModMusic::openFromFile(const std::string& filename)
 {
     close();
+    m_underruns = 0;
 
-    // Guess file type from extension
-    const char* ext = strrchr(filename.c_str(), '.');
-
-    if (strcmp(ext, ".mod") == 0) // Amiga module
-        m_module = dumb_load_mod_quick(filename.c_str());
-
-    else if (strcmp(ext, ".xm") == 0) // Fast Tracker II
-        m_module = dumb_load_xm_quick(filename.c_str());
+    // Ring buffer size must be a multiple of CHUNK_SIZE, so chunks never wrap around
+    size_t chunks = s_buffer_duration.asSeconds() * SAMPLING_RATE * NB_CHANNELS / CHUNK_SIZE + 1;
+    m_ring.assign(std::max<size_t>(chunks, 2) * CHUNK_SIZE, 0);
 
-    else if (strcmp(ext, ".s3m") == 0) // Scream Tracker 3
-        m_module = dumb_load_s3m_quick(filename.c_str());
-
-    else if (strcmp(ext, ".it") == 0) // Impulse Tracker
-        m_module = dumb_load_it_quick(filename.c_str());
+    std::string cache_path;
+    if (!s_cache_dir.empty())
+    {
+        // Stream the pre-rendered PCM file if available
+        cache_path = s_cache_dir + "/" + filename.substr(filename.find_last_of("/\\") + 1) + ".pcm";
+        m_pcm_file = std::fopen(cache_path.c_str(), "rb");
+        if (m_pcm_file != NULL)
+        {
+            std::fseek(m_pcm_file, 0, SEEK_END);
+            m_pcm_size = std::ftell(m_pcm_file) / sizeof (sf::Int16);
+            if (m_pcm_size >= CHUNK_SIZE)
+            {
+                initialize(NB_CHANNELS, SAMPLING_RATE);
+                return true;
+            }
+            std::cerr << "Ignoring invalid music cache file: " << cache_path << std::endl;
+            std::fclose(m_pcm_file);
+            m_pcm_file = NULL;
+        }
+    }
 
+    m_module = load_module(filename);
     if (m_module != NULL)
     {
+        if (!cache_path.empty())
+        {
+            // Render the PCM file in background, for the next time this music is played
+            stopPrerendering();
+            m_prerendering = true;
+            m_prerender_thread = std::thread(&ModMusic::prerender, this, filename, cache_path);
+        }
         initialize(NB_CHANNELS, SAMPLING_RATE);
         return true;
     }
@@ -63,14 +121,36 @@ bool ModMusic::openFromFile(const std::string& filename)
 
 sf::Time ModMusic::getDuration() const
 {
+    if (m_pcm_file != NULL)
+        return sf::seconds(static_cast<float>(m_pcm_size / NB_CHANNELS) / SAMPLING_RATE);
+
     // 65536 represents one second
     // Warning: 'duh_get_length' doesn't work if 'dumb_load_*_quick' is used in openFromFile
     return sf::seconds(static_cast<float>(duh_get_length(m_module) / 65536));
 }
 
 
+size_t ModMusic::getUnderrunCount() const
+{
+    return m_underruns;
+}
+
+
+void ModMusic::setCacheDirectory(const std::string& directory)
+{
+    s_cache_dir = directory;
+}
+
+
+void ModMusic::setBufferDuration(sf::Time duration)
+{
+    s_buffer_duration = duration;
+}
+
+
 void ModMusic::close()
 {
+    stopStreaming();
     if (m_player != NULL)
     {
         duh_end_sigrenderer(m_player);
@@ -81,27 +161,192 @@ void ModMusic::close()
         unload_duh(m_module);
         m_module = NULL;
     }
+    if (m_pcm_file != NULL)
+    {
+        std::fclose(m_pcm_file);
+        m_pcm_file = NULL;
+        m_pcm_size = 0;
+    }
 }
 
 
 void ModMusic::onSeek(sf::Time timeOffset)
 {
-    // When specifying the position, 0 represents the start of the DUH, and 65536 represents one second.
-    long pos = static_cast<long>(timeOffset.asSeconds() * 65536);
-    m_player = duh_start_sigrenderer(m_module, 0, NB_CHANNELS, pos);
+    stopStreaming();
+    if (m_pcm_file != NULL)
+    {
+        long pos = static_cast<long>(timeOffset.asSeconds() * SAMPLING_RATE) * NB_CHANNELS;
+        std::fseek(m_pcm_file, (pos % m_pcm_size) * sizeof (sf::Int16), SEEK_SET);
+    }
+    else if (m_module != NULL)
+    {
+        if (m_player != NULL)
+            duh_end_sigrenderer(m_player);
+
+        // When specifying the position, 0 represents the start of the DUH, and 65536 represents one second.
+        long pos = static_cast<long>(timeOffset.asSeconds() * 65536);
+        m_player = duh_start_sigrenderer(m_module, 0, NB_CHANNELS, pos);
+    }
+    else
+    {
+        return;
+    }
+    startStreaming();
 }
 
 
 bool ModMusic::onGetData(Chunk& data)
 {
+    // Called from the SFML audio thread: only copy samples already rendered by the streaming thread
+    size_t read_pos = m_read_pos;
+    if (m_write_pos - read_pos >= CHUNK_SIZE)
+    {
+        const sf::Int16* chunk = &m_ring[read_pos % m_ring.size()];
+        std::copy(chunk, chunk + CHUNK_SIZE, m_samples);
+        m_read_pos = read_pos + CHUNK_SIZE;
+    }
+    else
+    {
+        // Streaming thread fell behind, play silence rather than waiting
+        std::fill(m_samples, m_samples + CHUNK_SIZE, 0);
+        ++m_underruns;
+    }
+
+    data.samples = m_samples;
+    data.sampleCount = CHUNK_SIZE;
+    return true;
+}
+
+
+size_t ModMusic::render(sf::Int16* samples, size_t count)
+{
+    if (m_pcm_file != NULL)
+    {
+        size_t read = std::fread(samples, sizeof (sf::Int16), count, m_pcm_file);
+        if (read < count)
+        {
+            // End of file reached, loop from the beginning
+            std::rewind(m_pcm_file);
+            read += std::fread(samples + read, sizeof (sf::Int16), count - read, m_pcm_file);
+        }
+        return read;
+    }
+
     // Use delta to control the speed of the output signal. If you pass 1.0f, the resultant signal
     // will be suitable for a 65536-Hz sampling rate (which isn't a commonly used rate).
-    float delta =  65536.0f / SAMPLING_RATE;
+    float delta = 65536.0f / SAMPLING_RATE;
 
-    // le /2 est magique (sans lui, skipping)
-    duh_render(m_player, 16, 0, 1.0f, delta, BUFFER_SIZE / 2, m_samples);
+    // Size is given in samples per channel
+    return duh_render(m_player, 16, 0, 1.0f, delta, count / NB_CHANNELS, samples) * NB_CHANNELS;
+}
 
-    data.samples = m_samples;
-    data.sampleCount = BUFFER_SIZE;
-    return true;
+
+void ModMusic::startStreaming()
+{
+    m_read_pos = 0;
+    m_write_pos = 0;
+
+    // Pre-fill the first chunks, so playback doesn't start with an underrun
+    for (int i = 0; i < 2; ++i)
+    {
+        sf::Int16* chunk = &m_ring[m_write_pos];
+        size_t count = render(chunk, CHUNK_SIZE);
+        std::fill(chunk + count, chunk + CHUNK_SIZE, 0);
+        m_write_pos += CHUNK_SIZE;
+    }
+
+    m_streaming = true;
+    m_stream_thread = std::thread(&ModMusic::stream, this);
+}
+
+
+void ModMusic::stopStreaming()
+{
+    m_streaming = false;
+    if (m_stream_thread.joinable())
+        m_stream_thread.join();
+}
+
+
+void ModMusic::stream()
+{
+    while (m_streaming)
+    {
+        size_t write_pos = m_write_pos;
+        if (m_ring.size() - (write_pos - m_read_pos) >= CHUNK_SIZE)
+        {
+            sf::Int16* chunk = &m_ring[write_pos % m_ring.size()];
+            size_t count = render(chunk, CHUNK_SIZE);
+            std::fill(chunk + count, chunk + CHUNK_SIZE, 0);
+            m_write_pos = write_pos + CHUNK_SIZE;
+        }
+        else
+        {
+            // Ring buffer is full
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+}
+
+
+void ModMusic::stopPrerendering()
+{
+    m_prerendering = false;
+    if (m_prerender_thread.joinable())
+        m_prerender_thread.join();
+}
+
+
+void ModMusic::prerender(std::string module_path, std::string cache_path)
+{
+    // Use a dedicated module instance, the one being played belongs to the streaming thread
+    DUH* module = load_module(module_path);
+    if (module == NULL)
+        return;
+
+    DUH_SIGRENDERER* player = duh_start_sigrenderer(module, 0, NB_CHANNELS, 0);
+
+    // Stop rendering when the module loops, instead of looping forever
+    DUMB_IT_SIGRENDERER* it_player = duh_get_it_sigrenderer(player);
+    if (it_player != NULL)
+    {
+        dumb_it_set_loop_callback(it_player, &dumb_it_callback_terminate, NULL);
+        dumb_it_set_xm_speed_zero_callback(it_player, &dumb_it_callback_terminate, NULL);
+    }
+
+    // Render to a temporary file, so an interrupted rendering is never used as cache
+    std::string tmp_path = cache_path + ".tmp";
+    std::FILE* file = std::fopen(tmp_path.c_str(), "wb");
+    bool complete = false;
+    if (file != NULL)
+    {
+        const long frames_per_chunk = CHUNK_SIZE / NB_CHANNELS;
+        const long max_frames = PRERENDER_MAX_DURATION * SAMPLING_RATE;
+        float delta = 65536.0f / SAMPLING_RATE;
+        sf::Int16 samples[CHUNK_SIZE];
+        long total = 0;
+        while (m_prerendering && total < max_frames)
+        {
+            long frames = duh_render(player, 16, 0, 1.0f, delta, frames_per_chunk, samples);
+            std::fwrite(samples, sizeof (sf::Int16), frames * NB_CHANNELS, file);
+            total += frames;
+            if (frames < frames_per_chunk)
+            {
+                complete = total >= frames_per_chunk;
+                break;
+            }
+        }
+        std::fclose(file);
+    }
+    duh_end_sigrenderer(player);
+    unload_duh(module);
+
+    if (complete && std::rename(tmp_path.c_str(), cache_path.c_str()) == 0)
+    {
+        std::cout << "* music pre-rendered to " << cache_path << std::endl;
+    }
+    else
+    {
+        std::remove(tmp_path.c_str());
+    }
 }
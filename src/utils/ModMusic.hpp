@@ -1,6 +1,10 @@
 #ifndef MODMUSIC_HPP
 #define MODMUSIC_HPP
 
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
 #include <SFML/Audio.hpp>
 
 // DUMB library forward declarations
@@ -9,6 +13,9 @@ class DUH_SIGRENDERER;
 
 /**
  * SFML wrapper around DUMB library for playing module music files (mod, s3m, xm, it)
+ * Samples are rendered ahead of playback by a streaming thread into a ring buffer, so
+ * the SFML audio thread only copies samples. Modules can also be pre-rendered once to
+ * a PCM cache file, which is then streamed instead of the module.
  */
 class ModMusic: public sf::SoundStream
 {
@@ -27,6 +34,22 @@ public:
      */
     sf::Time getDuration() const;
 
+    /**
+     * Number of times the audio thread ran out of rendered samples since the music was opened
+     */
+    size_t getUnderrunCount() const;
+
+    /**
+     * Directory where modules are pre-rendered to PCM files
+     * @param directory: cache location, empty string disables pre-rendering
+     */
+    static void setCacheDirectory(const std::string& directory);
+
+    /**
+     * Amount of audio rendered ahead of playback (applied on next openFromFile)
+     */
+    static void setBufferDuration(sf::Time duration);
+
 private:
     static struct Init
     {
@@ -35,8 +58,8 @@ private:
     } s_init;
 
     static const int SAMPLING_RATE = 44100;
-    static const int BUFFER_SIZE   = SAMPLING_RATE;
     static const int NB_CHANNELS   = 2; // Stereo
+    static const int CHUNK_SIZE    = 4096 * NB_CHANNELS; // Samples per render/copy
 
     void close();
 
@@ -44,9 +67,44 @@ private:
 
     void onSeek(sf::Time timeOffset);
 
-    sf::Int16        m_samples[BUFFER_SIZE];
+    /**
+     * Render the next samples from the PCM cache file or from the module
+     * @return number of samples rendered
+     */
+    size_t render(sf::Int16* samples, size_t count);
+
+    /**
+     * Streaming thread: keep the ring buffer filled
+     */
+    void startStreaming();
+    void stopStreaming();
+    void stream();
+
+    /**
+     * Pre-rendering thread: render the whole module to a PCM cache file
+     */
+    void stopPrerendering();
+    void prerender(std::string module_path, std::string cache_path);
+
+    sf::Int16        m_samples[CHUNK_SIZE];
     DUH*             m_module;
     DUH_SIGRENDERER* m_player;
+    std::FILE*       m_pcm_file;
+    long             m_pcm_size; // PCM cache file size, in samples
+
+    // Ring buffer (single producer: streaming thread, single consumer: SFML audio thread)
+    std::vector<sf::Int16> m_ring;
+    std::atomic<size_t>    m_read_pos;
+    std::atomic<size_t>    m_write_pos;
+    std::atomic<size_t>    m_underruns;
+    std::atomic<bool>      m_streaming;
+    std::thread            m_stream_thread;
+
+    std::atomic<bool>      m_prerendering;
+    std::thread            m_prerender_thread;
+
+    static std::string s_cache_dir;
+    static sf::Time    s_buffer_duration;
 };
 
 
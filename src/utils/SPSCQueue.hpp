@@ -0,0 +1,61 @@
+#ifndef SPSCQUEUE_HPP
+#define SPSCQUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * Lock-free fixed-size queue, for one producer thread and one consumer thread
+ * @param T: element type, should be a small POD
+ * @param N: queue size (holds up to N - 1 elements)
+ */
+template <class T, size_t N>
+class SPSCQueue
+{
+public:
+    SPSCQueue():
+        m_head(0),
+        m_tail(0)
+    {
+    }
+
+    /**
+     * Append an element (producer thread only)
+     * @return false if queue is full
+     */
+    bool push(const T& value)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        size_t next = (tail + 1) % N;
+        if (next == m_head.load(std::memory_order_acquire))
+            return false;
+
+        m_items[tail] = value;
+        m_tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Remove the first element (consumer thread only)
+     * @return false if queue is empty
+     */
+    bool pop(T& value)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire))
+            return false;
+
+        value = m_items[head];
+        m_head.store((head + 1) % N, std::memory_order_release);
+        return true;
+    }
+
+private:
+    T m_items[N];
+
+    // Head and tail are written by different threads, keep them on separate cache lines
+    alignas(64) std::atomic<size_t> m_head; // Next element to read
+    alignas(64) std::atomic<size_t> m_tail; // Next element to write
+};
+
+#endif // SPSCQUEUE_HPP
@@ -39,4 +39,29 @@ std::string upper(const std::string& str)
     return result;
 }
 
+std::vector<std::string> split(const std::string& str, char separator)
+{
+    std::vector<std::string> result;
+    std::string::size_type begin = 0;
+    while (begin < str.length()) {
+        std::string::size_type end = str.find(separator, begin);
+        if (end == std::string::npos)
+            end = str.length();
+
+        std::string token = trim(str.substr(begin, end - begin));
+        if (!token.empty())
+            result.push_back(token);
+        begin = end + 1;
+    }
+    return result;
+}
+
+
+uint32_t hash_buffer(const char* data, size_t size, uint32_t value)
+{
+    for (size_t i = 0; i < size; ++i)
+        value = (value ^ static_cast<unsigned char>(data[i])) * 16777619u;
+    return value;
+}
+
 }
@@ -2,6 +2,8 @@
 #define STRINGUTILS_HPP
 
 #include <string>
+#include <cstdint>
+#include <vector>
 
 namespace utils {
 
@@ -25,6 +27,26 @@ std::string lower(const std::string& str);
  */
 std::string upper(const std::string& str);
 
+/**
+ * Split a string into trimmed tokens, empty tokens are skipped
+ */
+std::vector<std::string> split(const std::string& str, char separator);
+
+/**
+ * FNV-1a 32 bits hash of a null-terminated string
+ * Evaluated at compile time when str is a string literal. Recursion depth is the
+ * string length when evaluated at runtime: use hash_buffer for long strings.
+ */
+constexpr uint32_t hash(const char* str, uint32_t value = 2166136261u)
+{
+    return *str == '\0' ? value : hash(str + 1, (value ^ static_cast<unsigned char>(*str)) * 16777619u);
+}
+
+/**
+ * FNV-1a 32 bits hash of a buffer, same result as hash for the same characters
+ */
+uint32_t hash_buffer(const char* data, size_t size, uint32_t value = 2166136261u);
+
 }
 
 #endif // STRINGUTILS_HPP
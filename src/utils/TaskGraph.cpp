@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <thread>
+#include "TaskGraph.hpp"
+
+
+TaskGraph::TaskGraph():
+    m_running(0)
+{
+}
+
+
+TaskGraph::TaskID TaskGraph::add(const Task& task, const std::vector<TaskID>& dependencies)
+{
+    TaskID id = m_nodes.size();
+    Node node;
+    node.task = task;
+    node.pending = dependencies.size();
+    m_nodes.push_back(node);
+    for (TaskID dependency: dependencies)
+        m_nodes[dependency].successors.push_back(id);
+
+    return id;
+}
+
+
+void TaskGraph::run(size_t thread_count)
+{
+    if (thread_count == 0)
+        thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+
+    m_ready.clear();
+    for (TaskID id = 0; id < m_nodes.size(); ++id)
+        if (m_nodes[id].pending == 0)
+            m_ready.push_back(id);
+
+    // Ready tasks are popped from the back: start with the first added tasks
+    std::reverse(m_ready.begin(), m_ready.end());
+    m_error = std::exception_ptr();
+
+    // No more threads than tasks, the calling thread is one of them
+    std::vector<std::thread> threads;
+    thread_count = std::min(thread_count, m_nodes.size());
+    for (size_t i = 1; i < thread_count; ++i)
+        threads.push_back(std::thread(&TaskGraph::work, this));
+
+    work();
+    for (std::thread& thread: threads)
+        thread.join();
+
+    m_nodes.clear();
+    if (m_error)
+        std::rethrow_exception(m_error);
+}
+
+
+void TaskGraph::work()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;)
+    {
+        // Running tasks may make other tasks ready
+        while (m_ready.empty() && m_running > 0)
+            m_changed.wait(lock);
+
+        if (m_ready.empty() || m_error)
+        {
+            m_changed.notify_all();
+            return;
+        }
+
+        TaskID id = m_ready.back();
+        m_ready.pop_back();
+        ++m_running;
+
+        lock.unlock();
+        std::exception_ptr error;
+        try
+        {
+            m_nodes[id].task();
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+        lock.lock();
+
+        --m_running;
+        if (error)
+        {
+            if (!m_error)
+                m_error = error;
+        }
+        else
+        {
+            for (TaskID successor: m_nodes[id].successors)
+                if (--m_nodes[successor].pending == 0)
+                    m_ready.push_back(successor);
+        }
+        m_changed.notify_all();
+    }
+}
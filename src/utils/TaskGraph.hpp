@@ -0,0 +1,59 @@
+#ifndef TASKGRAPH_HPP
+#define TASKGRAPH_HPP
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+/**
+ * Set of tasks with dependencies, executed on a pool of threads
+ * A task starts once all its dependencies are completed. Dependencies can only
+ * refer to tasks already added, so the graph can't contain cycles.
+ */
+class TaskGraph
+{
+public:
+    typedef std::function<void()> Task;
+    typedef size_t TaskID;
+
+    TaskGraph();
+
+    /**
+     * Add a task
+     * @param dependencies: tasks which must be completed before this one starts
+     * @return task ID, to be used as a dependency of other tasks
+     */
+    TaskID add(const Task& task, const std::vector<TaskID>& dependencies = std::vector<TaskID>());
+
+    /**
+     * Execute all tasks and wait until they are completed
+     * The calling thread executes tasks too. If a task throws an exception, tasks not
+     * started yet are cancelled and the exception is thrown again by run.
+     * @param thread_count: maximum number of threads, 0 for the number of hardware threads
+     */
+    void run(size_t thread_count = 0);
+
+private:
+    /**
+     * Execute ready tasks until no task is left
+     */
+    void work();
+
+    struct Node
+    {
+        Task                task;
+        std::vector<TaskID> successors;
+        size_t              pending; // Number of dependencies not completed yet
+    };
+
+    std::vector<Node>       m_nodes;
+    std::vector<TaskID>     m_ready;   // Tasks waiting for a thread
+    size_t                  m_running; // Tasks being executed
+    std::exception_ptr      m_error;
+    std::mutex              m_mutex;
+    std::condition_variable m_changed; // Notified when a task is completed
+};
+
+#endif // TASKGRAPH_HPP
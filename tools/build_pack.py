@@ -0,0 +1,114 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+# Run this script to bundle images, sounds and fonts into a single
+# resource pack, memory-mapped by the Resources class at runtime.
+#
+# Usage: build_pack.py [resources_dir] [--verify]
+#
+# Pack layout (all integers are 32 bits, little-endian):
+#   header:  magic "CSRP", version, entry count, reserved
+#   entries: path hash, blob offset, blob size, CRC-32 (sorted by path hash)
+#   blobs:   file contents, each aligned on BLOB_ALIGNMENT bytes
+#
+# Paths are relative to the resources directory, such as "images/gui/button.png"
+
+import os
+import struct
+import sys
+import zlib
+
+from compile_lang import hash_key
+
+MAGIC = b"CSRP"
+VERSION = 1
+HEADER = struct.Struct("<4sIII")
+ENTRY = struct.Struct("<IIII")
+BLOB_ALIGNMENT = 16
+PACK_NAME = "resources.pack"
+DIRECTORIES = ("images", "sounds", "fonts")
+
+
+def list_files(resources_dir):
+    files = []
+    for directory in DIRECTORIES:
+        for root, dirs, names in os.walk(os.path.join(resources_dir, directory)):
+            for name in names:
+                path = os.path.relpath(os.path.join(root, name), resources_dir)
+                files.append(path.replace(os.sep, "/"))
+    return sorted(files)
+
+
+def align(offset):
+    return (offset + BLOB_ALIGNMENT - 1) // BLOB_ALIGNMENT * BLOB_ALIGNMENT
+
+
+def build_pack(resources_dir, target):
+    hashes = {}
+    for path in list_files(resources_dir):
+        key_hash = hash_key(path)
+        if key_hash in hashes:
+            raise ValueError("hash collision between '%s' and '%s'" % (path, hashes[key_hash]))
+        hashes[key_hash] = path
+
+    offset = align(HEADER.size + len(hashes) * ENTRY.size)
+    index = b""
+    blobs = []
+    for key_hash in sorted(hashes):
+        data = open(os.path.join(resources_dir, hashes[key_hash]), "rb").read()
+        index += ENTRY.pack(key_hash, offset, len(data), zlib.crc32(data) & 0xffffffff)
+        blobs.append((offset, data))
+        offset = align(offset + len(data))
+
+    with open(target, "wb") as f:
+        f.write(HEADER.pack(MAGIC, VERSION, len(hashes), 0))
+        f.write(index)
+        for blob_offset, data in blobs:
+            f.write(b"\0" * (blob_offset - f.tell()))
+            f.write(data)
+    return len(hashes)
+
+
+# Check pack integrity, and that it matches the resources directory
+def verify_pack(resources_dir, filename):
+    data = open(filename, "rb").read()
+    magic, version, count, reserved = HEADER.unpack_from(data, 0)
+    if magic != MAGIC or version != VERSION:
+        print("  %s is not a resource pack (version %d)" % (filename, VERSION))
+        return False
+
+    ok = True
+    entries = {}
+    for i in range(count):
+        key_hash, offset, size, crc = ENTRY.unpack_from(data, HEADER.size + i * ENTRY.size)
+        if offset + size > len(data) or zlib.crc32(data[offset:offset + size]) & 0xffffffff != crc:
+            print("  corrupted entry: %08x" % key_hash)
+            ok = False
+        entries[key_hash] = (offset, size)
+
+    for path in list_files(resources_dir):
+        entry = entries.pop(hash_key(path), None)
+        if entry is None:
+            print("  missing file: " + path)
+            ok = False
+        elif data[entry[0]:entry[0] + entry[1]] != open(os.path.join(resources_dir, path), "rb").read():
+            print("  outdated file: " + path)
+            ok = False
+    if entries:
+        print("  %d extra entries" % len(entries))
+        ok = False
+    return ok
+
+
+if __name__ == "__main__":
+    args = [arg for arg in sys.argv[1:] if arg != "--verify"]
+    resources_dir = args[0] if args else "resources/"
+    target = os.path.join(resources_dir, PACK_NAME)
+    if "--verify" in sys.argv:
+        print("* Verifying " + target)
+        if not verify_pack(resources_dir, target):
+            sys.exit(1)
+        print("  OK")
+    else:
+        count = build_pack(resources_dir, target)
+        print("* Packed %d files into %s (%d bytes)" % (count, target, os.path.getsize(target)))
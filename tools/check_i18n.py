@@ -2,29 +2,38 @@
 # -*- coding: utf-8 -*-
 
 # Run this script to check language files define exactly the same
-# string ids than en.lang (the reference language file)
+# string ids than en.lang (the reference language file), and that the
+# compiled language packs (see compile_lang.py) are up to date
 
 import os
 
+from compile_lang import parse_lang, read_pack, hash_key
+
 # Return the set of string ids defined in 'filename'
 def get_strings(filename):
-    strings = set()
-    for line in open(filename):
-        separator = line.find("=")
-        if separator != -1:
-            entry = line[:separator].strip()
-            strings.add(entry)
-    return strings
+    return set(key for key, text in parse_lang(filename))
+
+# Return True if the compiled pack matches the language file
+def check_pack(filename):
+    pack = filename + "c"
+    if not os.path.exists(pack):
+        print("  missing compiled pack: " + pack)
+        return False
+    expected = dict((hash_key(key), text) for key, text in parse_lang(filename))
+    if read_pack(pack) != expected:
+        print("  outdated compiled pack: " + pack + " (run tools/compile_lang.py)")
+        return False
+    return True
 
 lang_dir = "resources/lang/"
 reference = get_strings(lang_dir + "en.lang")
 
-for f in os.listdir(lang_dir):
-    if f != "en.lang":
+for f in sorted(os.listdir(lang_dir)):
+    if f.endswith(".lang"):
         print("* Checking " + f)
         strings = get_strings(lang_dir + f)
-        if strings == reference:
+        if strings == reference and check_pack(lang_dir + f):
             print("  OK (%d strings)" % len(strings))
-        else:
+        elif strings != reference:
             print("  missing strings: " + ", ".join(reference.difference(strings)))
             print("  extra strings: " + ", ".join(strings.difference(reference)))
@@ -0,0 +1,86 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+# Run this script to compare a benchmark report (cosmoscroll -bench report.json)
+# against a baseline report, and detect performance regressions.
+#
+# Usage: compare_bench.py report.json baseline.json [--tolerance 0.10] [--update]
+#
+# A metric regresses when it exceeds the baseline value by more than the tolerance
+# (relative). Timings below MIN_MS are ignored, as they are mostly noise.
+# --update replaces the baseline with the report.
+# Exit status is 1 if any metric regressed.
+
+import json
+import shutil
+import sys
+
+DEFAULT_TOLERANCE = 0.10
+MIN_MS = 0.05
+
+# (stat, field) pairs checked for each level
+METRICS = (
+    ("sim_ms", "p50"),
+    ("sim_ms", "p95"),
+    ("sim_ms", "p99"),
+    ("allocations", "mean"),
+    ("allocations", "max"),
+)
+
+
+def load_levels(filename):
+    with open(filename) as f:
+        report = json.load(f)
+    return dict((level["level"], level) for level in report["levels"])
+
+
+def compare(report, baseline, tolerance):
+    regressions = 0
+    for number in sorted(report):
+        level = report[number]
+        base = baseline.get(number)
+        if base is None:
+            print("level %d: not in baseline" % number)
+            continue
+
+        if level["trace"] != base["trace"] or level["frames"] != base["frames"]:
+            print("level %d: warning, played %d frames (%s), baseline played %d frames (%s)" % (
+                number, level["frames"], level["trace"], base["frames"], base["trace"]))
+
+        for stat, field in METRICS:
+            value = level[stat][field]
+            reference = base[stat][field]
+            if stat == "sim_ms" and max(value, reference) < MIN_MS:
+                continue
+            limit = reference * (1 + tolerance)
+            status = "ok"
+            if value > limit:
+                status = "REGRESSION"
+                regressions += 1
+            print("level %d: %s.%s = %g (baseline %g) %s" % (number, stat, field, value, reference, status))
+    return regressions
+
+
+if __name__ == "__main__":
+    args = sys.argv[1:]
+    tolerance = DEFAULT_TOLERANCE
+    update = "--update" in args
+    if update:
+        args.remove("--update")
+    if "--tolerance" in args:
+        index = args.index("--tolerance")
+        tolerance = float(args[index + 1])
+        del args[index:index + 2]
+    if len(args) != 2:
+        print("usage: compare_bench.py report.json baseline.json [--tolerance 0.10] [--update]")
+        sys.exit(2)
+
+    report_file, baseline_file = args
+    if update:
+        shutil.copyfile(report_file, baseline_file)
+        print("baseline updated: %s" % baseline_file)
+        sys.exit(0)
+
+    regressions = compare(load_levels(report_file), load_levels(baseline_file), tolerance)
+    print("%d regression(s), tolerance %d%%" % (regressions, tolerance * 100))
+    sys.exit(1 if regressions else 0)
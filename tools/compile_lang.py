@@ -0,0 +1,103 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+# Run this script to compile the language files (*.lang) into binary
+# language packs (*.langc), loaded by the I18n class at runtime.
+#
+# Pack layout (all integers are 32 bits, little-endian):
+#   header:  magic "CSLP", version, entry count, blob length
+#   entries: key hash, blob offset, string length (sorted by key hash)
+#   blob:    UTF-32 code points of all the translated strings
+
+import io
+import os
+import struct
+import sys
+
+MAGIC = b"CSLP"
+VERSION = 1
+HEADER = struct.Struct("<4sIII")
+ENTRY = struct.Struct("<III")
+
+
+# FNV-1a 32 bits hash, must match utils::hash
+def hash_key(key):
+    h = 2166136261
+    for byte in bytearray(key.encode("utf-8")):
+        h = ((h ^ byte) * 16777619) & 0xffffffff
+    return h
+
+
+# Return the ordered list of (key, text) defined in 'filename'
+def parse_lang(filename):
+    entries = []
+    keys = set()
+    for line_number, line in enumerate(io.open(filename, encoding="utf-8"), 1):
+        line = line.rstrip("\r\n")
+        if not line or line.startswith("#"):
+            continue
+        separator = line.find("=")
+        if separator == -1:
+            print("  error at line %d: %s" % (line_number, line))
+            continue
+        key = line[:separator].strip(" \t\r\n")
+        text = line[separator + 1:].strip(" \t\r\n").replace("\\n", "\n")
+        # First definition wins, like I18n::loadFromFile
+        if key not in keys:
+            keys.add(key)
+            entries.append((key, text))
+    return entries
+
+
+# Return the {hash: text} dictionary stored in a compiled pack
+def read_pack(filename):
+    data = open(filename, "rb").read()
+    magic, version, count, blob_size = HEADER.unpack_from(data, 0)
+    if magic != MAGIC or version != VERSION:
+        raise ValueError("%s is not a language pack (version %d)" % (filename, VERSION))
+    blob_start = HEADER.size + count * ENTRY.size
+    blob = struct.unpack_from("<%dI" % blob_size, data, blob_start)
+    strings = {}
+    for i in range(count):
+        key_hash, offset, length = ENTRY.unpack_from(data, HEADER.size + i * ENTRY.size)
+        strings[key_hash] = u"".join(chr_utf32(c) for c in blob[offset:offset + length])
+    return strings
+
+
+def chr_utf32(code_point):
+    return struct.pack("<I", code_point).decode("utf-32-le")
+
+
+def compile_lang(source, target):
+    entries = parse_lang(source)
+    hashes = {}
+    for key, text in entries:
+        key_hash = hash_key(key)
+        if key_hash in hashes:
+            raise ValueError("hash collision between '%s' and '%s'" % (key, hashes[key_hash][0]))
+        hashes[key_hash] = (key, text)
+
+    index = b""
+    blob = b""
+    offset = 0
+    for key_hash in sorted(hashes):
+        text = hashes[key_hash][1].encode("utf-32-le")
+        length = len(text) // 4
+        index += ENTRY.pack(key_hash, offset, length)
+        blob += text
+        offset += length
+
+    with open(target, "wb") as f:
+        f.write(HEADER.pack(MAGIC, VERSION, len(hashes), offset))
+        f.write(index)
+        f.write(blob)
+    return len(hashes)
+
+
+if __name__ == "__main__":
+    lang_dir = sys.argv[1] if len(sys.argv) > 1 else "resources/lang/"
+    for f in sorted(os.listdir(lang_dir)):
+        if f.endswith(".lang"):
+            source = os.path.join(lang_dir, f)
+            target = source + "c"
+            print("* Compiling %s (%d strings)" % (target, compile_lang(source, target)))
@@ -0,0 +1,108 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+# Run this script to generate a levels file with a single stress level, which
+# spawns many spaceships and asteroids to measure engine performance.
+#
+# Usage: gen_stress_level.py [options] > stress.xml (see --help)
+#
+# The output is compatible with resources/xml/levels.xml: use it in place of
+# levels.xml in a copy of the resources directory (cosmoscroll -r <dir>), then
+# play it with -autopilot or -bench.
+# The same kind of level can be generated in-game with: cosmoscroll -stress <ships/s>
+
+import argparse
+import random
+import sys
+from xml.sax.saxutils import quoteattr
+
+MOVEMENTS = ("line", "magnet", "sinus", "circle")  # Spaceship::MovementPattern
+ATTACKS = ("auto_aim", "on_sight", "none")         # Spaceship::AttackPattern
+# Spaceships with a weapon, from resources/xml/spaceships.xml
+DEFAULT_SHIPS = "b1,b1c,b2,b2c,b3,s1,s2"
+MIN_Y = 10
+MAX_Y = 360
+# Gun towers are placed ahead of the view (640 pixels wide), they sleep until they enter it
+DECOR_X = 640 + 400
+
+
+def generate(args):
+    rng = random.Random(args.seed)
+    ships = [ship for ship in args.ships.split(",") if ship]
+    moves = args.moves.split(",")
+    attacks = args.attacks.split(",")
+
+    # (time, tag) spawn events, ships and asteroids are merged by time
+    events = []
+    if args.ships_per_second > 0 and ships:
+        count = int(args.duration * args.ships_per_second)
+        for i in range(count):
+            attributes = 'id=%s move=%s attack=%s' % (
+                quoteattr(ships[i % len(ships)]), quoteattr(rng.choice(moves)), quoteattr(rng.choice(attacks)))
+            events.append((i / args.ships_per_second, "ship", attributes))
+    if args.asteroids_per_second > 0:
+        count = int(args.duration * args.asteroids_per_second)
+        for i in range(count):
+            events.append((i / args.asteroids_per_second, "asteroid", ""))
+    if args.decors_per_second > 0:
+        count = int(args.duration * args.decors_per_second)
+        for i in range(count):
+            events.append((i / args.decors_per_second, "decor", 'id="guntower" x="%d"' % DECOR_X))
+    events.sort(key=lambda event: event[0])
+
+    lines = []
+    last_time = 0.0
+    for time, tag, attributes in events:
+        if tag == "decor":
+            # Gun towers are always at the bottom
+            lines.append('      <%s %s t="%g"/>' % (tag, attributes, time - last_time))
+        else:
+            y = rng.randint(MIN_Y, MAX_Y)
+            lines.append('      <%s %sy="%d" t="%g"/>' % (tag, attributes + " " if attributes else "", y, time - last_time))
+        last_time = time
+    if args.boss:
+        lines.append('      <boss id=%s y="100" t="5"/>' % quoteattr(args.boss))
+
+    return "\n".join([
+        '<?xml version="1.0" encoding="utf-8" ?>',
+        "<levelset>",
+        "  <functions/>",
+        "  <levels>",
+        "    <!-- %g ships/s, %g asteroids/s, %g decors/s, %gs, seed %d -->" % (
+            args.ships_per_second, args.asteroids_per_second, args.decors_per_second, args.duration, args.seed),
+        '    <level layer1="layers/blue.jpg" layer2="layers/fog.png" color="#002060" stars="30" music="tempested.mod">',
+    ] + lines + [
+        "    </level>",
+        "  </levels>",
+        "</levelset>",
+        "",
+    ])
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Generate a stress level for cosmoscroll")
+    parser.add_argument("--ships-per-second", type=float, default=4, help="spaceships spawned per second")
+    parser.add_argument("--asteroids-per-second", type=float, default=1, help="big asteroids spawned per second")
+    parser.add_argument("--decors-per-second", type=float, default=0.25, help="gun towers spawned ahead of the view per second")
+    parser.add_argument("--duration", type=float, default=120, help="spawning duration, in seconds")
+    parser.add_argument("--ships", default=DEFAULT_SHIPS, help="comma-separated spaceship ids, used in turn")
+    parser.add_argument("--moves", default=",".join(MOVEMENTS), help="comma-separated movement patterns")
+    parser.add_argument("--attacks", default=",".join(ATTACKS[:2]), help="comma-separated attack patterns")
+    parser.add_argument("--boss", default="", help="boss id spawned at the end (tentaculat, flying-saucer, brain, evil)")
+    parser.add_argument("--seed", type=int, default=1, help="seed for spawn positions and patterns")
+    parser.add_argument("-o", "--output", help="output file (default: standard output)")
+    args = parser.parse_args()
+
+    for move in args.moves.split(","):
+        if move not in MOVEMENTS:
+            parser.error("unknown movement pattern: %s" % move)
+    for attack in args.attacks.split(","):
+        if attack not in ATTACKS:
+            parser.error("unknown attack pattern: %s" % attack)
+
+    xml = generate(args)
+    if args.output:
+        with open(args.output, "w") as f:
+            f.write(xml)
+    else:
+        sys.stdout.write(xml)